@@ -18,14 +18,40 @@ subject to the following restrictions:
 #include "btAlignedObjectArray.h"
 #include "btVector3.h"
 
+class btConvexHullInternal;
+namespace VHACD {
+class QuickHull;
+class HullPointFilter;
+}
+
 /// Convex hull implementation based on Preparata and Hong
 /// See http://code.google.com/p/bullet/issues/detail?id=275
 /// Ole Kniemeyer, MAXON Computer GmbH
 class btConvexHullComputer {
 private:
+    btConvexHullInternal* internal; // working memory, reused by successive compute() calls
+    VHACD::QuickHull* quickHull; // same for the floating-point hull
+    VHACD::HullPointFilter* pointFilter; // same for the point pre-filter
+    btAlignedObjectArray<int32_t> quickHullEdges; // output edge of each half-edge of the floating-point hull
+
     btScalar compute(const void* coords, bool doubleCoords, int32_t stride, int32_t count, btScalar shrink, btScalar shrinkClamp);
+    void copyQuickHull(const void* coords, int32_t stride);
+
+    btConvexHullComputer(const btConvexHullComputer&);
+    btConvexHullComputer& operator=(const btConvexHullComputer&);
 
 public:
+    btConvexHullComputer()
+        : internal(NULL)
+        , quickHull(NULL)
+        , pointFilter(NULL)
+        , useQuickHull(false)
+        , usePointFilter(false)
+    {
+    }
+
+    ~btConvexHullComputer();
+
     class Edge {
     private:
         int32_t next;
@@ -70,6 +96,28 @@ public:
     // Faces of the convex hull. Each entry is an index into the "edges" array pointing to an edge of the face. Faces are planar n-gons
     btAlignedObjectArray<int32_t> faces;
 
+    // If true, the hull of double precision points that are not shrunken is first computed by a floating-point Quickhull,
+    // whose predicates are certified by error bounds, and the exact (integer) algorithm only runs when they fail. The
+    // vertices are then the input points themselves. VHACD::VoxelSet also computes its hulls exactly on the lattice of
+    // the voxel corners when it is set.
+    bool useQuickHull;
+
+    // Quickhull working memory of this computer, also used directly for the exact hull of lattice points
+    VHACD::QuickHull& getQuickHull();
+
+    // If true, the double precision points strictly inside the polytope of their extreme points along 13 fixed axes
+    // are discarded before the hull is computed (Akl-Toussaint heuristic). The hull is unchanged, but the order of its
+    // vertices can differ
+    bool usePointFilter;
+
+    // Pre-filter of this computer, whose counters give the number of discarded points
+    VHACD::HullPointFilter& getPointFilter();
+
+    // Point buffers (x, y, z triplets) of the hulls of VHACD::VoxelSet and VHACD::TetrahedronSet, which hull their
+    // points cluster by cluster and then the vertices of all the cluster hulls. Reused by successive hulls
+    btAlignedObjectArray<double> clusterPoints;
+    btAlignedObjectArray<double> clusterHullPoints;
+
     /*
 		Compute convex hull of "count" vertices stored in "coords". "stride" is the difference in bytes
 		between the addresses of consecutive vertices. If "shrink" is positive, the convex hull is shrunken
@@ -0,0 +1,72 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_ARENA_H
+#define VHACD_ARENA_H
+#include "vhacdAllocator.h"
+#include <stdint.h>
+#include <vector>
+
+#define ARENA_CHUNK_SIZE (4 << 20)
+#define ARENA_MIN_BLOCK_SIZE 16
+#define ARENA_NUM_SIZE_CLASSES 17 // 16 bytes to 1 MB
+
+namespace VHACD {
+//! Allocator for the temporaries of a decomposition. Blocks are rounded up to a power of two size class, recycled
+//! through one free list per class, and otherwise carved out of large chunks by a bump pointer. Reset() makes all the
+//! chunks available again at once, without returning them to the heap, so successive decompositions stop allocating
+//! once warmed up. Blocks larger than the largest class come from the heap, and are not counted in the memory
+//! statistics, which describe the chunks. An arena is not thread-safe: VHACD owns one per thread.
+class Arena : public Allocator {
+public:
+    void* Allocate(const size_t size);
+    void* Reallocate(void* const ptr, const size_t oldSize, const size_t newSize);
+    void Free(void* const ptr, const size_t size);
+    //! Resets the counters and recycles all the chunks. If blocks are still in use, the chunks are kept as they are, so
+    //! that these blocks stay valid, and false is returned.
+    bool Reset();
+    //! Returns the chunks to the heap. The blocks still in use become invalid: their owner must not free them.
+    void Release();
+    //! Number of blocks allocated and not freed yet
+    size_t GetNLiveBlocks() const { return m_nLiveBlocks; }
+    //! Largest number of bytes in use in the chunks since the last Reset(), including the rounding to the size classes
+    size_t GetHighWaterMark() const { return m_highWaterMark; }
+    //! Bytes held by the chunks
+    size_t GetReservedBytes() const { return m_reservedBytes; }
+    //! Number of calls to Allocate() since the last Reset()
+    size_t GetNAllocations() const { return m_nAllocations; }
+
+    //! Constructor.
+    Arena();
+    //! Destructor.
+    ~Arena(void);
+
+private:
+    static int32_t GetSizeClass(const size_t size);
+    void* AllocateBlock(const int32_t sizeClass);
+
+    std::vector<char*> m_chunks;
+    std::vector<size_t> m_chunkSizes;
+    size_t m_chunk; // chunk blocks are currently carved out of
+    size_t m_offset; // in that chunk
+    void* m_freeBlocks[ARENA_NUM_SIZE_CLASSES]; // the first bytes of a free block point to the next one
+    size_t m_bytesInUse;
+    size_t m_nLiveBlocks;
+    size_t m_highWaterMark;
+    size_t m_reservedBytes;
+    size_t m_nAllocations;
+};
+}
+#endif // VHACD_ARENA_H
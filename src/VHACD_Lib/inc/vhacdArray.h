@@ -0,0 +1,238 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_ARRAY_H
+#define VHACD_ARRAY_H
+#include "vhacdAllocator.h"
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+
+#define ARRAY_MIN_CAPACITY 16
+
+namespace VHACD {
+//! Dynamic array of trivially copyable elements, with the interface of SArray but no inline storage: the elements are
+//! moved with memcpy, the buffer grows geometrically with realloc, and arrays are moved or swapped without copying
+//! their elements. The memory comes from an optional Allocator, which travels with the buffer when the array is moved
+//! but is not inherited by copies, or from malloc/realloc/free. Like new[] in SArray, running out of memory throws
+//! std::bad_alloc, the array being left unchanged.
+template <typename T>
+class Array {
+    static_assert(std::is_trivially_copyable<T>::value, "Array moves its elements with memcpy and realloc");
+
+public:
+    T& operator[](size_t i) { return m_data[i]; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+    size_t Size() const { return m_size; }
+    size_t Capacity() const { return m_capacity; }
+    T* Data() { return m_data; }
+    const T* Data() const { return m_data; }
+    Allocator* GetAllocator() const { return m_allocator; }
+    //! Sets the memory source of an array that has no buffer
+    void SetAllocator(Allocator* const allocator)
+    {
+        Clear();
+        m_allocator = allocator;
+    }
+    //! Removes all the elements and frees the buffer
+    void Clear()
+    {
+        Release(m_data, m_capacity);
+        m_data = 0;
+        m_size = 0;
+        m_capacity = 0;
+    }
+    void PopBack()
+    {
+        --m_size;
+    }
+    //! Makes room for 'capacity' elements, without changing the size
+    void Reserve(size_t capacity)
+    {
+        if (capacity > m_capacity) {
+            Reallocate(capacity);
+        }
+    }
+    //! Same as Reserve, for compatibility with SArray
+    void Allocate(size_t capacity)
+    {
+        Reserve(capacity);
+    }
+    //! Frees the capacity beyond the size
+    void ShrinkToFit()
+    {
+        if (m_size == 0) {
+            Clear();
+        }
+        else if (m_size < m_capacity) {
+            Reallocate(m_size);
+        }
+    }
+    //! Sets the size, the new elements being uninitialized
+    void Resize(size_t size)
+    {
+        if (size > m_capacity) {
+            Reallocate(GrownCapacity(size));
+        }
+        m_size = size;
+    }
+    void PushBack(const T& value)
+    {
+        if (m_size == m_capacity) {
+            // 'value' may be an element of this array
+            const T copy = value;
+            Reallocate(GrownCapacity(m_size + 1));
+            m_data[m_size++] = copy;
+        }
+        else {
+            m_data[m_size++] = value;
+        }
+    }
+    bool Find(const T& value, size_t& pos)
+    {
+        for (pos = 0; pos < m_size; ++pos)
+            if (value == m_data[pos])
+                return true;
+        return false;
+    }
+    bool Insert(const T& value)
+    {
+        size_t pos;
+        if (Find(value, pos))
+            return false;
+        PushBack(value);
+        return true;
+    }
+    bool Erase(const T& value)
+    {
+        size_t pos;
+        if (Find(value, pos)) {
+            memmove(m_data + pos, m_data + pos + 1, (m_size - pos - 1) * sizeof(T));
+            --m_size;
+            return true;
+        }
+        return false;
+    }
+    void Swap(Array& rhs)
+    {
+        T* const data = m_data;
+        const size_t size = m_size;
+        const size_t capacity = m_capacity;
+        Allocator* const allocator = m_allocator;
+        m_data = rhs.m_data;
+        m_size = rhs.m_size;
+        m_capacity = rhs.m_capacity;
+        m_allocator = rhs.m_allocator;
+        rhs.m_data = data;
+        rhs.m_size = size;
+        rhs.m_capacity = capacity;
+        rhs.m_allocator = allocator;
+    }
+    //! Copies the elements of 'rhs', keeping the allocator of this array
+    Array& operator=(const Array& rhs)
+    {
+        if (this != &rhs) {
+            if (rhs.m_size > m_capacity) {
+                // the old elements are not needed
+                Clear();
+                Reallocate(rhs.m_size);
+            }
+            m_size = rhs.m_size;
+            if (m_size) {
+                memcpy(m_data, rhs.m_data, m_size * sizeof(T));
+            }
+        }
+        return *this;
+    }
+    //! Takes the buffer, and the allocator, of 'rhs', which is left empty
+    Array& operator=(Array&& rhs)
+    {
+        if (this != &rhs) {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+    //! The copy uses malloc, so that it can outlive the allocator of 'rhs'
+    Array(const Array& rhs)
+    {
+        Initialize(0);
+        *this = rhs;
+    }
+    Array(Array&& rhs)
+    {
+        Initialize(rhs.m_allocator);
+        Swap(rhs);
+    }
+    explicit Array(Allocator* const allocator = 0)
+    {
+        Initialize(allocator);
+    }
+    ~Array()
+    {
+        Release(m_data, m_capacity);
+    }
+
+private:
+    void Initialize(Allocator* const allocator)
+    {
+        m_data = 0;
+        m_size = 0;
+        m_capacity = 0;
+        m_allocator = allocator;
+    }
+    size_t GrownCapacity(size_t size) const
+    {
+        size_t capacity = (m_capacity < ARRAY_MIN_CAPACITY) ? ARRAY_MIN_CAPACITY : 2 * m_capacity;
+        return (capacity < size) ? size : capacity;
+    }
+    void Reallocate(size_t capacity)
+    {
+        T* data;
+        if (m_allocator) {
+            data = (T*)(m_data ? m_allocator->Reallocate(m_data, m_capacity * sizeof(T), capacity * sizeof(T))
+                               : m_allocator->Allocate(capacity * sizeof(T)));
+        }
+        else {
+            data = (T*)realloc(m_data, capacity * sizeof(T));
+        }
+        if (!data) {
+            // the old buffer is still valid
+            throw std::bad_alloc();
+        }
+        m_data = data;
+        m_capacity = capacity;
+    }
+    void Release(T* const data, size_t capacity)
+    {
+        if (!data) {
+            return;
+        }
+        if (m_allocator) {
+            m_allocator->Free(data, capacity * sizeof(T));
+        }
+        else {
+            free(data);
+        }
+    }
+
+    T* m_data;
+    size_t m_size;
+    size_t m_capacity;
+    Allocator* m_allocator;
+};
+}
+#endif // VHACD_ARRAY_H
@@ -0,0 +1,54 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_HULL_POINT_FILTER_H
+#define VHACD_HULL_POINT_FILTER_H
+#include "vhacdQuickHull.h"
+#include <stdint.h>
+#include <vector>
+
+namespace VHACD {
+//! Akl-Toussaint heuristic: the extreme points of a point set along 13 fixed axes (the 26 directions of a k-DOP) span
+//! a polytope contained in its convex-hull, and the points strictly inside that polytope can be discarded before the
+//! hull is computed. The test against the faces of the polytope is done on blocks of points stored as structures of
+//! arrays, so that it vectorizes, and a point is only discarded if it is inside by more than the rounding error and the
+//! snapping of btConvexHullComputer, so that the hull it computes is not changed.
+class HullPointFilter {
+public:
+    //! Filters 'nPoints' points, stored 'stride' bytes apart. Returns false if no point can be discarded, otherwise
+    //! the remaining points are available through GetPoints().
+    bool Filter(const double* const points, const int32_t stride, const int32_t nPoints);
+    int32_t GetNPoints() const { return static_cast<int32_t>(m_points.size() / 3); }
+    const double* GetPoints() const { return m_points.empty() ? 0 : &m_points[0]; }
+    //! Counters accumulated over the calls to Filter() since the last ResetCounters()
+    uint64_t GetNInputPoints() const { return m_nInputPoints; }
+    uint64_t GetNRejectedPoints() const { return m_nRejectedPoints; }
+    void ResetCounters();
+
+    //! Constructor.
+    HullPointFilter();
+    //! Destructor.
+    ~HullPointFilter(void) {}
+
+private:
+    QuickHull m_polytope; // hull of the extreme points
+    std::vector<double> m_extremePoints;
+    std::vector<double> m_planes; // (nx, ny, nz, d - tolerance) of the faces of the polytope
+    std::vector<double> m_points;
+    uint64_t m_nInputPoints;
+    uint64_t m_nRejectedPoints;
+};
+}
+#endif // VHACD_HULL_POINT_FILTER_H
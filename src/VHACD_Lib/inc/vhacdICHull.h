@@ -48,6 +48,8 @@ public:
     bool IsInside(const Vec3<double>& pt0, const double eps = 0.0);
     //!
     const ICHull& operator=(ICHull& rhs);
+    //! Removes all the points, so that the instance can be reused for another convex-hull
+    void Clear();
 
     //!    Constructor
     ICHull();
@@ -82,7 +84,6 @@ private:
     bool MakeCCW(CircularListElement<TMMTriangle>* f,
         CircularListElement<TMMEdge>* e,
         CircularListElement<TMMVertex>* v);
-    void Clear();
 
 private:
     static const int32_t sc_dummyIndex;
@@ -0,0 +1,247 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_INDEXED_ICHULL_H
+#define VHACD_INDEXED_ICHULL_H
+#include "vhacdICHull.h"
+#include "vhacdSArray.h"
+#include "vhacdVector.h"
+#include <vector>
+
+namespace VHACD {
+//!    Circular list with the semantics of CircularList (an added element is inserted after the head and becomes the
+//!    new head, deleting the head moves it to the next element), whose elements are stored in a contiguous array and
+//!    referred to by index. Deleted elements are recycled through a free list, and Clear() keeps the memory.
+template <typename T>
+class IndexedCircularList {
+public:
+    //! Returns the data of the element i
+    T& operator[](const int32_t i) { return m_elements[i].m_data; }
+    const T& operator[](const int32_t i) const { return m_elements[i].m_data; }
+    //! Returns the data of the head
+    T& GetData() { return m_elements[m_head].m_data; }
+    int32_t GetNext(const int32_t i) const { return m_elements[i].m_next; }
+    int32_t GetPrev(const int32_t i) const { return m_elements[i].m_prev; }
+    int32_t& GetHead() { return m_head; }
+    int32_t GetHead() const { return m_head; }
+    size_t GetSize() const { return m_size; }
+    //! Returns the number of allocated elements (element indices are smaller than this)
+    size_t GetCapacity() const { return m_elements.size(); }
+    void Next()
+    {
+        if (m_size) {
+            m_head = m_elements[m_head].m_next;
+        }
+    }
+    void Prev()
+    {
+        if (m_size) {
+            m_head = m_elements[m_head].m_prev;
+        }
+    }
+    //! Adds an element after the head, and makes it the head
+    int32_t Add()
+    {
+        int32_t i;
+        if (m_free.empty()) {
+            i = static_cast<int32_t>(m_elements.size());
+            m_elements.push_back(Element());
+        }
+        else {
+            i = m_free.back();
+            m_free.pop_back();
+            m_elements[i].m_data = T();
+        }
+        if (m_size == 0) {
+            m_elements[i].m_next = m_elements[i].m_prev = i;
+        }
+        else {
+            const int32_t next = m_elements[m_head].m_next;
+            m_elements[i].m_next = next;
+            m_elements[i].m_prev = m_head;
+            m_elements[m_head].m_next = i;
+            m_elements[next].m_prev = i;
+        }
+        m_head = i;
+        ++m_size;
+        return i;
+    }
+    //! Deletes the element i (the head moves to the next element if i is the head)
+    bool Delete(const int32_t i)
+    {
+        if (m_size > 1) {
+            const int32_t next = m_elements[i].m_next;
+            const int32_t prev = m_elements[i].m_prev;
+            if (i == m_head) {
+                m_head = next;
+            }
+            m_elements[next].m_prev = prev;
+            m_elements[prev].m_next = next;
+            m_free.push_back(i);
+            --m_size;
+            return true;
+        }
+        else if (m_size == 1) {
+            m_free.push_back(m_head);
+            m_head = -1;
+            --m_size;
+            return true;
+        }
+        return false;
+    }
+    //! Deletes the head
+    bool Delete() { return Delete(m_head); }
+    void Clear()
+    {
+        m_elements.resize(0);
+        m_free.resize(0);
+        m_head = -1;
+        m_size = 0;
+    }
+    //!    Constructor
+    IndexedCircularList()
+    {
+        m_head = -1;
+        m_size = 0;
+    }
+
+private:
+    struct Element {
+        T m_data;
+        int32_t m_next;
+        int32_t m_prev;
+    };
+    std::vector<Element> m_elements;
+    std::vector<int32_t> m_free;
+    int32_t m_head;
+    size_t m_size;
+};
+
+//!    Incremental convex hull with the same algorithm as ICHull, but whose vertices, edges and triangles are kept in
+//!    contiguous arrays, linked by indices, instead of one heap-allocated element each. Each edge record holds both of
+//!    its sides (two vertices, two triangles), as ICHull's edges do, which keeps the traversal orders of ICHull.
+//!    Each triangle keeps the list of the points that see it (its conflict list), so that the volume seen by each point,
+//!    which drives the choice of the next point to add, is only updated for the points that saw the replaced triangles.
+//!    The points whose side of some triangle is within the rounding error of the volume (e.g. coplanar points) may see
+//!    a new triangle without seeing its neighbours: they are checked against every new triangle, as ICHull does.
+//!    The volumes are summed incrementally, so the points that may have the largest one are compared with the volumes
+//!    ICHull sums over the triangles, which makes both choose the same points.
+class IndexedICHull {
+public:
+    static const double sc_eps;
+    //!
+    bool IsFlat() const { return m_isFlat; }
+    //!    Add points to the convex-hull
+    bool AddPoints(const Vec3<double>* points, size_t nPoints);
+    //!    Computes the convex-hull of at most nPointsCH of the added points (see ICHull::Process())
+    ICHullError Process(const uint32_t nPointsCH, const double minVolume = 0.0);
+    //! Returns the number of vertices of the convex-hull
+    size_t GetNVertices() const { return m_vertices.GetSize(); }
+    //! Returns the number of triangles of the convex-hull
+    size_t GetNTriangles() const { return m_triangles.GetSize(); }
+    //! Copies the convex-hull as an indexed face set
+    void GetIFS(Vec3<double>* const points, Vec3<int32_t>* const triangles);
+    //! Removes all the points, so that the instance can be reused for another convex-hull
+    void Clear();
+
+    //!    Constructor
+    IndexedICHull();
+    //! Destructor
+    ~IndexedICHull(void){};
+
+private:
+    struct Vertex {
+        Vec3<double> m_pos;
+        int32_t m_name;
+        int32_t m_id;
+        int32_t m_duplicate; // incident cone edge (or -1)
+        int32_t m_point; // index of the conflict data of the vertex
+        bool m_onHull;
+        bool m_tag;
+        Vertex() : m_name(0), m_id(0), m_duplicate(-1), m_point(-1), m_onHull(false), m_tag(false) {}
+    };
+    struct Edge {
+        int32_t m_triangles[2];
+        int32_t m_vertices[2];
+        int32_t m_newFace;
+        Edge() : m_newFace(-1)
+        {
+            m_triangles[0] = m_triangles[1] = -1;
+            m_vertices[0] = m_vertices[1] = -1;
+        }
+    };
+    struct Triangle {
+        int32_t m_edges[3];
+        int32_t m_vertices[3];
+        int32_t m_conflicts; // first entry of the conflict list (or -1)
+        bool m_visible;
+        Triangle() : m_conflicts(-1), m_visible(false)
+        {
+            m_edges[0] = m_edges[1] = m_edges[2] = -1;
+            m_vertices[0] = m_vertices[1] = m_vertices[2] = -1;
+        }
+    };
+
+    //! Entry of a conflict list: a point that sees a triangle, and the volume of the tetrahedron they form
+    struct Conflict {
+        double m_volume;
+        int32_t m_point;
+        int32_t m_next;
+    };
+
+    ICHullError DoubleTriangle();
+    int32_t MakeFace(const int32_t v0, const int32_t v1, const int32_t v2, const int32_t fold);
+    int32_t MakeConeFace(const int32_t e, const int32_t p);
+    bool MakeCCW(const int32_t f, const int32_t e, const int32_t v);
+    bool MarkVisibleFaces();
+    bool ProcessPoint();
+    bool FindMaxVolumePoint(const double minVolume);
+    double ComputePointVolume(const int32_t v) const;
+    bool CleanEdges();
+    bool CleanVertices(uint32_t& addedPoints);
+    bool CleanTriangles();
+    bool CleanUp(uint32_t& addedPoints);
+    bool CheckConsistancy();
+    void InitConflicts();
+    bool AddConflict(const int32_t f, const int32_t point);
+    void AddUncertainPoint(const int32_t point);
+    void UpdateConflicts();
+    const Vec3<double>& GetPos(const int32_t v) const { return m_vertices[v].m_pos; }
+
+    static const int32_t sc_dummyIndex;
+    IndexedCircularList<Vertex> m_vertices;
+    IndexedCircularList<Edge> m_edges;
+    IndexedCircularList<Triangle> m_triangles;
+    SArray<int32_t> m_edgesToDelete;
+    SArray<int32_t> m_edgesToUpdate;
+    SArray<int32_t> m_trianglesToDelete;
+    SArray<Conflict> m_conflicts;
+    int32_t m_freeConflicts; // first unused entry of m_conflicts (or -1)
+    SArray<int32_t> m_pointVertices; // vertex of each point
+    SArray<double> m_pointVolumes; // volume seen by each point (sum over its conflict triangles)
+    SArray<double> m_pointVolumeErrors; // bound of the rounding error of m_pointVolumes
+    SArray<int32_t> m_pointNConflicts; // number of triangles seen by each point
+    SArray<int32_t> m_pointStamps; // last horizon edge for which each point was checked
+    SArray<int32_t> m_uncertainPoints; // points checked against every new triangle
+    SArray<char> m_pointUncertain; // whether each point is in m_uncertainPoints
+    int32_t m_stamp;
+    SArray<int32_t> m_trianglesToDuplicate;
+    Vec3<double> m_normal;
+    bool m_isFlat;
+    IndexedICHull(const IndexedICHull& rhs);
+    IndexedICHull& operator=(const IndexedICHull& rhs);
+};
+}
+#endif // VHACD_INDEXED_ICHULL_H
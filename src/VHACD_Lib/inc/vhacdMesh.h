@@ -15,10 +15,14 @@
 #pragma once
 #ifndef VHACD_MESH_H
 #define VHACD_MESH_H
+#include "vhacdArray.h"
 #include "vhacdSArray.h"
 #include "vhacdVector.h"
 
+class btConvexHullComputer;
+
 #define VHACD_DEBUG_MESH
+#define MERGE_CULLING_TOLERANCE 1.0e-9
 
 namespace VHACD {
 enum AXIS {
@@ -92,13 +96,25 @@ public:
         ClearPoints();
         ClearTriangles();
     }
+    //! Sets the memory source of the points and triangles, which are removed
+    void SetAllocator(Allocator* const allocator)
+    {
+        m_points.SetAllocator(allocator);
+        m_triangles.SetAllocator(allocator);
+    }
+    Allocator* GetAllocator() const { return m_points.GetAllocator(); }
     void ResizePoints(size_t nPts) { m_points.Resize(nPts); }
     void ResizeTriangles(size_t nTri) { m_triangles.Resize(nTri); }
-    void CopyPoints(SArray<Vec3<double> >& points) const { points = m_points; }
+    void CopyPoints(SArray<Vec3<double> >& points) const
+    {
+        points.Resize(m_points.Size());
+        memcpy(points.Data(), m_points.Data(), m_points.Size() * sizeof(Vec3<double>));
+    }
     double GetDiagBB() const { return m_diag; }
     double ComputeVolume() const;
     void ComputeConvexHull(const double* const pts,
-        const size_t nPts);
+        const size_t nPts,
+        btConvexHullComputer* const hullComputer = 0); // hullComputer: optional, reused working memory
     void Clip(const Plane& plane,
         SArray<Vec3<double> >& positivePart,
         SArray<Vec3<double> >& negativePart) const;
@@ -117,14 +133,60 @@ public:
     Mesh();
     //! Destructor.
     ~Mesh(void);
+    //! Copy and move: moving a mesh hands its buffers over instead of copying them.
+    Mesh(const Mesh& rhs) = default;
+    Mesh(Mesh&& rhs) = default;
+    Mesh& operator=(const Mesh& rhs) = default;
+    Mesh& operator=(Mesh&& rhs) = default;
 
 private:
-    SArray<Vec3<double> > m_points;
-    SArray<Vec3<int32_t> > m_triangles;
+    Array<Vec3<double> > m_points;
+    Array<Vec3<int32_t> > m_triangles;
     Vec3<double> m_minBB;
     Vec3<double> m_maxBB;
     Vec3<double> m_center;
     double m_diag;
 };
+
+//! Immutable convex-hull. Its volume, centroid, bounding box and face planes are computed once, at construction.
+class ConvexHullMesh {
+public:
+    const Mesh& GetMesh() const { return m_mesh; }
+    const Vec3<double>& GetPoint(size_t index) const { return m_mesh.GetPoint(index); }
+    size_t GetNPoints() const { return m_mesh.GetNPoints(); }
+    const Vec3<int32_t>& GetTriangle(size_t index) const { return m_mesh.GetTriangle(index); }
+    size_t GetNTriangles() const { return m_mesh.GetNTriangles(); }
+    double GetVolume() const { return m_volume; }
+    const Vec3<double>& GetCenter() const { return m_center; }
+    const Vec3<double>& GetMinBB() const { return m_minBB; }
+    const Vec3<double>& GetMaxBB() const { return m_maxBB; }
+    //! Planes of the (non-degenerate) triangles, oriented so that the interior is on their positive side.
+    const Array<Plane>& GetPlanes() const { return m_planes; }
+    //! Appends the vertices which are not strictly inside the convex-hull other. Since the hull of the union of the
+    //! two convex-hulls is spanned by the remaining vertices of both, the culled ones never contribute to it.
+    void AddPointsOutside(const ConvexHullMesh& other, SArray<Vec3<double> >& pts) const;
+
+    //! Constructor: copies the points and triangles of the convex mesh.
+    ConvexHullMesh(const Mesh& mesh);
+    //! Constructor: takes the points and triangles of the convex mesh.
+    ConvexHullMesh(Mesh&& mesh);
+    //! Destructor.
+    ~ConvexHullMesh(void);
+    //! Copy and move: the hull is immutable, so it can be copied or moved into a new one but not assigned.
+    ConvexHullMesh(const ConvexHullMesh& rhs) = default;
+    ConvexHullMesh(ConvexHullMesh&& rhs) = default;
+    ConvexHullMesh& operator=(const ConvexHullMesh& rhs) = delete;
+    ConvexHullMesh& operator=(ConvexHullMesh&& rhs) = delete;
+
+private:
+    void Init();
+
+    Mesh m_mesh;
+    Array<Plane> m_planes;
+    Vec3<double> m_minBB;
+    Vec3<double> m_maxBB;
+    Vec3<double> m_center;
+    double m_volume;
+};
 }
 #endif
\ No newline at end of file
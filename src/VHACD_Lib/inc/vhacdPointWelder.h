@@ -0,0 +1,54 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_POINT_WELDER_H
+#define VHACD_POINT_WELDER_H
+#include "vhacdVector.h"
+#include <stdint.h>
+#include <vector>
+
+namespace VHACD {
+//! Welds points closer than a given distance: a point is added unless a point within the weld distance was already
+//! added, in which case it is welded to it. The added points are bucketed in a uniform hash grid whose cells are
+//! (slightly larger than) the weld distance, so only the 27 cells around a point are searched and welding n points
+//! is O(n) instead of O(n^2).
+class PointWelder {
+public:
+    //! Removes all the points and sets the weld distance; 'expectedPoints' sizes the hash table
+    void Reset(const double distance, const size_t expectedPoints = 0);
+    //! Returns the index of the point 'pt' is welded to, which is GetNPoints() - 1 if 'pt' was added
+    size_t Weld(const Vec3<double>& pt);
+    size_t GetNPoints() const { return m_points.size(); }
+    const Vec3<double>& GetPoint(const size_t i) const { return m_points[i]; }
+    const Vec3<double>* GetPoints() const { return m_points.empty() ? 0 : &m_points[0]; }
+
+    //! Constructor.
+    PointWelder();
+    //! Destructor.
+    ~PointWelder(void) {}
+
+private:
+    void GetCell(const Vec3<double>& pt, int64_t cell[3]) const;
+    size_t GetBucket(const int64_t x, const int64_t y, const int64_t z) const;
+    void Rehash(const size_t nBuckets);
+
+    std::vector<Vec3<double> > m_points;
+    std::vector<int32_t> m_next; // next point of the same bucket, -1 at the end of the list
+    std::vector<int32_t> m_buckets; // first point of each bucket, -1 if empty
+    double m_distance2;
+    double m_invCellSize;
+};
+}
+#endif // VHACD_POINT_WELDER_H
@@ -0,0 +1,126 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+#ifndef VHACD_QUICK_HULL_H
+#define VHACD_QUICK_HULL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace VHACD {
+//! Floating-point Quickhull with certified predicates. The side of a point with respect to a face is only trusted when
+//! the orientation determinant exceeds its static error bound (Shewchuk's orient3d filter); a point whose side is
+//! uncertain is treated as lying on the face. Compute() fails, so that the caller can fall back to an exact algorithm,
+//! when the points are (nearly) degenerate, when the faces seen from a new vertex do not form a disk, or when an edge
+//! of the result can not be certified convex. Points with integer coordinates, such as the corners of voxels, are
+//! processed with exact 64-bit integer predicates instead, which only fail on degenerate inputs.
+//! As in btConvexHullComputer, the coplanar triangles of the result are merged into convex polygons and the points lying
+//! on an edge or inside a face of the hull are not reported as vertices.
+class QuickHull {
+public:
+    //! Computes the convex-hull of 'nPoints' points, stored 'stride' bytes apart. Returns false if the result can not
+    //! be certified.
+    bool Compute(const double* const points, const int32_t stride, const int32_t nPoints);
+    //! Computes the exact convex-hull of 'nPoints' lattice points (x, y, z), whose coordinate extent must be below
+    //! 2^20. Returns false if the points are coplanar or the extent is too large.
+    bool Compute(const int32_t* const points, const int32_t nPoints);
+    //! Returns the number of vertices of the convex-hull
+    int32_t GetNVertices() const { return static_cast<int32_t>(m_hullVertices.size()); }
+    //! Returns the index, in the input points, of the vertex v
+    int32_t GetVertex(const int32_t v) const { return m_hullVertices[v]; }
+    //! Returns the number of faces of the convex-hull
+    int32_t GetNFaces() const { return static_cast<int32_t>(m_hullFaceOffsets.size()) - 1; }
+    //! Returns the number of vertices of the face f
+    int32_t GetFaceSize(const int32_t f) const { return m_hullFaceOffsets[f + 1] - m_hullFaceOffsets[f]; }
+    //! Returns the vertices of the face f, a convex polygon counter-clockwise seen from outside
+    const int32_t* GetFace(const int32_t f) const { return &m_hullFaceVertices[m_hullFaceOffsets[f]]; }
+    //! Returns the first half-edge of the face f: the half-edge GetFaceEdge(f) + i goes from GetFace(f)[i] to
+    //! GetFace(f)[(i + 1) % GetFaceSize(f)]
+    int32_t GetFaceEdge(const int32_t f) const { return m_hullFaceOffsets[f]; }
+    //! Returns the half-edge going in the opposite direction of the half-edge h, in the adjacent face
+    int32_t GetTwinEdge(const int32_t h) const { return m_hullTwinEdges[h]; }
+    //! Returns the scratch buffer of the lattice points passed to Compute(), so that successive calls do not allocate
+    std::vector<int32_t>& GetLatticeBuffer() { return m_latticeBuffer; }
+
+    //! Constructor.
+    QuickHull();
+    //! Destructor.
+    ~QuickHull(void) {}
+
+private:
+    struct Face {
+        int32_t m_vertices[3]; // input points, counter-clockwise seen from outside
+        int32_t m_adjacent[3]; // face adjacent to the edge (m_vertices[i], m_vertices[(i + 1) % 3])
+        int32_t m_outside; // first point of the outside set (or -1)
+        int32_t m_farthest; // point of the outside set farthest from the face (or -1)
+        double m_farthestDistance;
+        int32_t m_stamp;
+        bool m_visible;
+        bool m_alive;
+    };
+    struct HorizonEdge {
+        int32_t m_v0;
+        int32_t m_v1;
+        int32_t m_face; // non visible face
+        int32_t m_edge; // index of the edge (m_v1, m_v0) in m_face
+    };
+
+    const double* GetPoint(const int32_t p) const
+    {
+        return reinterpret_cast<const double*>(reinterpret_cast<const char*>(m_points) + static_cast<size_t>(p) * m_stride);
+    }
+    const int32_t* GetLatticePoint(const int32_t p) const { return m_latticePoints + 3 * static_cast<size_t>(p); }
+    void GetCoordinates(const int32_t p, double* const pt) const;
+    bool Compute(const int32_t nPoints);
+    double Side(const Face& face, const int32_t p) const;
+    bool InitSimplex();
+    int32_t AddFace(const int32_t v0, const int32_t v1, const int32_t v2);
+    void AddToOutside(const int32_t f, const int32_t p, const double distance);
+    void AssignPoint(const int32_t p, const int32_t* const faces, const size_t nFaces);
+    bool AddVertex(const int32_t f);
+    bool CheckConvexity() const;
+    bool Compact();
+
+    const double* m_points;
+    const int32_t* m_latticePoints; // non null when the points are integer
+    int32_t m_stride;
+    int32_t m_nPoints;
+    int32_t m_stamp;
+    std::vector<Face> m_faces;
+    std::vector<int32_t> m_freeFaces;
+    std::vector<int32_t> m_nextOutside; // next point of the same outside set (or -1)
+    std::vector<int32_t> m_pendingFaces; // faces whose outside set may not be empty
+    std::vector<int32_t> m_visibleFaces;
+    std::vector<HorizonEdge> m_horizon;
+    std::vector<int32_t> m_vertexStamps;
+    std::vector<int32_t> m_vertexHorizon; // horizon edge starting at each vertex
+    std::vector<int32_t> m_orphans; // points of the outside sets of the visible faces
+    std::vector<int32_t> m_newFaces;
+    std::vector<int32_t> m_faceGroups; // coplanar group of each face (or -1)
+    std::vector<int32_t> m_groupFaces; // faces sorted by group
+    std::vector<int32_t> m_groupOffsets; // first face of each group in m_groupFaces
+    std::vector<int32_t> m_vertexGroups; // first two groups incident to each point (or -1)
+    std::vector<int32_t> m_boundaryNext; // next point on the boundary of the current group (or -1)
+    std::vector<int32_t> m_edgeOffsets; // first outgoing half-edge of each vertex of the hull in m_vertexEdges
+    std::vector<int32_t> m_vertexEdges; // half-edges sorted by vertex of the hull they leave
+    std::vector<int32_t> m_edgeTargets; // vertex of the hull each half-edge goes to
+    std::vector<int32_t> m_latticeBuffer;
+    std::vector<int32_t> m_hullVertices;
+    std::vector<int32_t> m_hullFaceOffsets;
+    std::vector<int32_t> m_hullFaceVertices;
+    std::vector<int32_t> m_hullTwinEdges;
+};
+}
+#endif // VHACD_QUICK_HULL_H
@@ -7,7 +7,7 @@
 namespace VHACD
 {
 
-    // Very simple brute force raycast against a triangle mesh.  Tests every triangle; no hierachy.
+    // Raycast against a triangle mesh, accelerated by a bounding volume hierarchy (SAH-built, flattened in depth-first order).
     // Does a deep copy, always does calculations with full double float precision
     class RaycastMesh
     {
@@ -29,6 +29,16 @@ namespace VHACD
             double *hitLocation,			// The point where the ray hit nearest to the 'closestToPoint' location
             double *hitDistance) = 0;		// The distance the ray traveled to the hit location
 
+        // Casts 'rayCount' rays starting at 'from', as many 'raycast' calls would. 'to', 'closestToPoints' and 'hitLocations'
+        // hold one point (x,y,z) per ray, 'hitDistances' and 'hits' one value per ray. Returns the number of rays which hit.
+        virtual uint32_t raycastBatch(uint32_t rayCount,
+            const double *from,
+            const double *to,
+            const double *closestToPoints,
+            double *hitLocations,
+            double *hitDistances,
+            bool *hits) = 0;
+
         virtual void release(void) = 0;
     protected:
         virtual ~RaycastMesh(void) { };
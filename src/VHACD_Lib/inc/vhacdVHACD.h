@@ -24,15 +24,122 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #endif
 #endif //OPENCL_FOUND
 
-#include "vhacdMutex.h"
 #include "vhacdVolume.h"
+#include "vhacdArena.h"
+#include "vhacdIndexedICHull.h"
+#include "vhacdPointWelder.h"
 #include "vhacdRaycastMesh.h"
+#include "btConvexHullComputer.h"
+#include <atomic>
 #include <vector>
 
 #define USE_THREAD 1
 #define OCL_MIN_NUM_PRIMITIVES 4096
 #define CH_APP_MIN_NUM_PRIMITIVES 64000
+#define PLANE_SEARCH_COARSE_SAMPLES 8
+#define PLANE_SEARCH_MAX_BRACKETS 3
+#define MAX_DOUBLE (1.79769e+308)
+#define MERGE_BOUND_TOLERANCE 1.0e-6
 namespace VHACD {
+//! Per-thread scratch memory of the clipping plane evaluation. Owned by the VHACD instance and reused by all the
+//! ComputeBestClippingPlane() calls, so that evaluating planes does not allocate once the buffers have grown.
+class PlaneEvaluationWorkspace {
+public:
+    SArray<Vec3<double> > m_leftCHPts;
+    SArray<Vec3<double> > m_rightCHPts;
+    SArray<Vec3<double> > m_extremePts;
+    Mesh m_leftCH;
+    Mesh m_rightCH;
+    btConvexHullComputer m_hullComputer;
+    IndexedICHull m_icHull; // used by SimplifyConvexHull
+    PointWelder m_pointWelder; // welds the projected vertices
+    SArray<Vec3<double> > m_rayTargets;
+    SArray<Vec3<double> > m_rayHits;
+    SArray<double> m_rayHitDistances;
+    SArray<bool> m_rayHitFlags;
+    PrimitiveSet* m_left; // only used when convex-hulls are not approximated
+    PrimitiveSet* m_right;
+    // best plane found by this thread, reduced with the other threads' once the loop is over
+    Plane m_bestPlane;
+    double m_minTotal;
+    double m_minConcavity;
+    double m_minBalance;
+    double m_minSymmetry;
+    int32_t m_iBest;
+
+    //! Constructor.
+    PlaneEvaluationWorkspace()
+    {
+        m_left = 0;
+        m_right = 0;
+        ResetBestPlane();
+    }
+    //! Destructor.
+    ~PlaneEvaluationWorkspace(void)
+    {
+        delete m_left;
+        delete m_right;
+    }
+    void ResetBestPlane()
+    {
+        m_minTotal = MAX_DOUBLE;
+        m_minConcavity = MAX_DOUBLE;
+        m_minBalance = MAX_DOUBLE;
+        m_minSymmetry = MAX_DOUBLE;
+        m_iBest = -1;
+    }
+
+private:
+    PlaneEvaluationWorkspace(const PlaneEvaluationWorkspace&);
+    PlaneEvaluationWorkspace& operator=(const PlaneEvaluationWorkspace&);
+};
+//! Candidate merge of two convex-hulls (m_p1 < m_p2). m_version1 and m_version2 are the versions of the hulls when
+//! the cost was computed (0 for a leaf hull, else the number of merges when it was created): once one of them has been
+//! merged the candidate is stale and skipped when it reaches the top of the queue (lazy invalidation).
+struct HullMergeCandidate {
+    float m_cost;
+    int32_t m_p1;
+    int32_t m_p2;
+    uint32_t m_version1;
+    uint32_t m_version2;
+    bool m_exact; // false if m_cost is only a lower bound of the cost (lazy merge)
+    // ties are broken by hull indices to keep the merge order deterministic
+    bool operator>(const HullMergeCandidate& rhs) const
+    {
+        return m_cost > rhs.m_cost || (m_cost == rhs.m_cost && (m_p1 > rhs.m_p1 || (m_p1 == rhs.m_p1 && m_p2 > rhs.m_p2)));
+    }
+};
+//! Interval of the adaptive clipping plane search: a local minimum of the coarse cost curve of one axis, bracketed by
+//! its two coarse neighbours.
+struct PlaneSearchBracket {
+    AXIS m_axis;
+    int32_t m_lo;
+    int32_t m_hi;
+    double m_predictedCost;
+    bool m_active;
+    bool operator<(const PlaneSearchBracket& rhs) const
+    {
+        return m_predictedCost < rhs.m_predictedCost;
+    }
+};
+//! Merge of the convex-hulls in slots m_p1 and m_p2 (m_p1 < m_p2) of the leaf hulls, m_hull taking the place of m_p1.
+//! The merged hulls are output in the order of their positions (see ApplyHullMerge()).
+struct HullMergeRecord {
+    int32_t m_p1;
+    int32_t m_p2;
+    ConvexHullMesh* m_hull;
+};
+//! OpenCL buffers used to compute the clipped volumes of a voxel set during the clipping plane evaluation.
+struct OCLClippedVolumes {
+#ifdef CL_VERSION_1_1
+    cl_mem m_voxels;
+    cl_mem* m_partialVolumes;
+    size_t m_globalSize;
+    size_t m_nWorkGroups;
+    size_t m_nPrimitives;
+    double m_unitVolume;
+#endif //CL_VERSION_1_1
+};
 class VHACD : public IVHACD {
 public:
     //! Constructor.
@@ -51,29 +158,62 @@ public:
         m_oclKernelComputePartialVolumes = 0;
         m_oclKernelComputeSum = 0;
 #endif //CL_VERSION_1_1
+        m_workspaces = new PlaneEvaluationWorkspace[m_ompNumProcessors];
+        m_onSurfacePSet = 0;
+        m_arenas = new Arena[m_ompNumProcessors];
+        m_mergeTolerance = 0.0;
         Init();
     }
     //! Destructor.
     ~VHACD(void) 
     {
+        ReleaseMergeHistory();
+        delete[] m_workspaces;
+        delete m_onSurfacePSet;
+        delete[] m_arenas;
     }
     uint32_t GetNConvexHulls() const
     {
         return (uint32_t)m_convexHulls.Size();
     }
+    uint32_t GetNEvaluatedClippingPlanes() const
+    {
+        return (uint32_t)m_nEvaluatedPlanes;
+    }
+    uint32_t GetNScreenedClippingPlanes() const
+    {
+        return (uint32_t)m_nScreenedPlanes;
+    }
     void Cancel()
     {
         SetCancel(true);
     }
     void GetConvexHull(const uint32_t index, ConvexHull& ch) const
     {
-        Mesh* mesh = m_convexHulls[index];
-        ch.m_nPoints = (uint32_t)mesh->GetNPoints();
-        ch.m_nTriangles = (uint32_t)mesh->GetNTriangles();
-        ch.m_points = mesh->GetPoints();
-        ch.m_triangles = (uint32_t *)mesh->GetTriangles();
-		ch.m_volume = mesh->ComputeVolume();
-		Vec3<double> &center = mesh->ComputeCenter();
+        ExportConvexHull(m_convexHulls[index], ch);
+    }
+    bool ComputeLODs(const uint32_t* const maxConvexHulls, const uint32_t nLODs);
+    uint32_t GetNLODs() const
+    {
+        return (uint32_t)m_lodConvexHulls.size();
+    }
+    uint32_t GetNLODConvexHulls(const uint32_t lod) const
+    {
+        return (uint32_t)m_lodConvexHulls[lod].Size();
+    }
+    void GetLODConvexHull(const uint32_t lod, const uint32_t index, ConvexHull& ch) const
+    {
+        ExportConvexHull(m_lodConvexHulls[lod][index], ch);
+    }
+    static void ExportConvexHull(const ConvexHullMesh* const hull, ConvexHull& ch)
+    {
+        const Mesh& mesh = hull->GetMesh();
+        ch.m_nPoints = (uint32_t)mesh.GetNPoints();
+        ch.m_nTriangles = (uint32_t)mesh.GetNTriangles();
+        ch.m_points = const_cast<double*>(mesh.GetPoints());
+        ch.m_triangles = (uint32_t *)const_cast<int32_t*>(mesh.GetTriangles());
+		ch.m_volume = hull->GetVolume();
+		const Vec3<double> &center = hull->GetCenter();
 		ch.m_center[0] = center.X();
 		ch.m_center[1] = center.Y();
 		ch.m_center[2] = center.Z();
@@ -92,6 +232,13 @@ public:
             delete m_convexHulls[p];
         }
         m_convexHulls.Clear();
+        ReleaseMergeHistory();
+        // the workspaces allocate from the arenas
+        ReleasePlaneEvaluationWorkspaces();
+        ReleasePlaneSearchBuffers();
+        for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+            m_arenas[i].Release();
+        }
         Init();
     }
     void Release(void)
@@ -108,6 +255,7 @@ public:
         const uint32_t* const triangles,
         const uint32_t nTriangles,
         const Parameters& params);
+    bool Remerge(const uint32_t maxConvexHulls);
     bool OCLInit(void* const oclDevice,
         IUserLogger* const logger = 0);
     bool OCLRelease(IUserLogger* const logger = 0);
@@ -117,17 +265,11 @@ public:
 private:
     void SetCancel(bool cancel)
     {
-        m_cancelMutex.Lock();
-        m_cancel = cancel;
-        m_cancelMutex.Unlock();
+        m_cancel.store(cancel, std::memory_order_relaxed);
     }
     bool GetCancel()
     {
-
-        m_cancelMutex.Lock();
-        bool cancel = m_cancel;
-        m_cancelMutex.Unlock();
-        return cancel;
+        return m_cancel.load(std::memory_order_relaxed);
     }
     void Update(const double stageProgress,
         const double operationProgress,
@@ -143,6 +285,23 @@ private:
                 m_operation.c_str());
         }
     }
+    // Counts one evaluated plane. Only the master thread forwards the progress to the user callback,
+    // so that a slow callback never stalls the other threads.
+    void UpdatePlaneProgress(std::atomic<int32_t>& done,
+        int32_t& reported,
+        const int32_t threadID,
+        const int32_t nPlanes,
+        const double progress0,
+        const double progress1,
+        const Parameters& params)
+    {
+        const int32_t nDone = done.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (threadID == 0 && nDone - reported >= 128) // reduce update frequency
+        {
+            reported = nDone;
+            Update(m_stageProgress, nDone * (progress1 - progress0) / nPlanes + progress0, params);
+        }
+    }
     void Init()
     {
 		if (mRaycastMesh)
@@ -160,18 +319,70 @@ private:
         m_operationProgress = 0.0;
         m_stage = "";
         m_operation = "";
+        m_nEvaluatedPlanes = 0;
+        m_nScreenedPlanes = 0;
+        m_maxBestPlaneProxyRank = -1;
         m_barycenter[0] = m_barycenter[1] = m_barycenter[2] = 0.0;
         m_rot[0][0] = m_rot[1][1] = m_rot[2][2] = 1.0;
         SetCancel(false);
     }
     void ComputePrimitiveSet(const Parameters& params);
+    void PreparePlaneEvaluationWorkspaces(const Parameters& params);
+    void ReleasePlaneEvaluationWorkspaces();
+    void ReleasePlaneSearchBuffers();
+    void ResetArenas(const Parameters& params);
     void ComputeACD(const Parameters& params);
+    void ReleaseMergeHistory()
+    {
+        for (size_t p = 0; p < m_leafHulls.Size(); ++p) {
+            delete m_leafHulls[p];
+        }
+        m_leafHulls.Clear();
+        for (size_t m = 0; m < m_mergeHistory.size(); ++m) {
+            delete m_mergeHistory[m].m_hull;
+        }
+        m_mergeHistory.clear();
+        m_mergeTolerance = 0.0;
+        ReleaseLODs();
+    }
+    void ReleaseLODs()
+    {
+        for (size_t l = 0; l < m_lodConvexHulls.size(); ++l) {
+            for (size_t p = 0; p < m_lodConvexHulls[l].Size(); ++p) {
+                delete m_lodConvexHulls[l][p];
+            }
+        }
+        m_lodConvexHulls.clear();
+    }
     void MergeConvexHulls(const Parameters& params);
-    void SimplifyConvexHull(Mesh* const ch, const size_t nvertices, const double minVolume);
-    void SimplifyConvexHulls(const Parameters& params);
+    void CopyMergedHulls(const uint32_t maxConvexHulls, SArray<ConvexHullMesh*>& output) const;
+    double ComputeMergeCost(const HullMergeCandidate& candidate, const std::vector<const ConvexHullMesh*>& hulls,
+        PlaneEvaluationWorkspace& workspace);
+    double ComputeMergeCostBound(const int32_t p1, const int32_t p2, const std::vector<const ConvexHullMesh*>& hulls,
+        const std::vector<Vec3<double> >& extremePts, const std::vector<int32_t>& nExtremePts,
+        PlaneEvaluationWorkspace& workspace);
+    void ComputeMergeCosts(std::vector<HullMergeCandidate>& candidates, const std::vector<const ConvexHullMesh*>& hulls,
+        const std::vector<Vec3<double> >& extremePts, const std::vector<int32_t>& nExtremePts, const bool lazy);
+    void SimplifyConvexHull(Mesh* const ch, const size_t nvertices, const double minVolume, PlaneEvaluationWorkspace& workspace);
+    void SimplifyConvexHulls(SArray<ConvexHullMesh*>* const hullSets, const size_t nHullSets, const Parameters& params);
     void ComputeBestClippingPlane(const PrimitiveSet* inputPSet,
         const double volume,
-        const SArray<Plane>& planes,
+        const Array<Plane>& planes,
+        const Vec3<double>& preferredCuttingDirection,
+        const double w,
+        const double alpha,
+        const double beta,
+        const int32_t convexhullDownsampling,
+        const double progress0,
+        const double progress1,
+        Plane& bestPlane,
+        double& minConcavity,
+        const Parameters& params,
+        SArray<double>* const costs = 0);
+    template <class T, bool CH_APPROXIMATION>
+    void EvaluateClippingPlanes(const T* const inputPSet,
+        const T* const onSurfacePSet,
+        const Array<Plane>& planes,
         const Vec3<double>& preferredCuttingDirection,
         const double w,
         const double alpha,
@@ -179,6 +390,41 @@ private:
         const int32_t convexhullDownsampling,
         const double progress0,
         const double progress1,
+        const bool oclAcceleration,
+        const OCLClippedVolumes& ocl,
+        SArray<double>* const costs,
+        const Parameters& params);
+#ifdef CL_VERSION_1_1
+    void EnqueueClippedVolumesOCL(const int32_t threadID,
+        const Plane& plane,
+        const OCLClippedVolumes& ocl,
+        const Parameters& params);
+    void ReadClippedVolumesOCL(const int32_t threadID,
+        const OCLClippedVolumes& ocl,
+        double& volumeRight,
+        double& volumeLeft,
+        const Parameters& params);
+#endif //CL_VERSION_1_1
+    void ComputeClippingPlanesProxyCosts(const PrimitiveSet* inputPSet,
+        const Array<Plane>& planes,
+        const Vec3<double>& preferredCuttingDirection,
+        const double w,
+        const double alpha,
+        const double beta,
+        const int32_t convexhullDownsampling,
+        const double progress0,
+        const double progress1,
+        SArray<double>& costs,
+        const Parameters& params);
+    void ComputeBestClippingPlaneAdaptive(const PrimitiveSet* inputPSet,
+        const double volume,
+        const Vec3<double>& preferredCuttingDirection,
+        const double w,
+        const double alpha,
+        const double beta,
+        const double progress0,
+        const double progress1,
+        const double progress2,
         Plane& bestPlane,
         double& minConcavity,
         const Parameters& params);
@@ -316,6 +562,8 @@ private:
         const Parameters& params)
     {
         Init();
+        ReleaseMergeHistory();
+        m_params = params;
         if (params.m_projectHullVertices)
         {
             mRaycastMesh = RaycastMesh::createRaycastMesh(nPoints, points, nTriangles, (const uint32_t *)triangles);
@@ -327,8 +575,13 @@ private:
         VoxelizeMesh(points, 3, nPoints, (int32_t *)triangles, 3, nTriangles, params);
         ComputePrimitiveSet(params);
         ComputeACD(params);
+        // the leaf hulls are kept, with the merges applied to them, for Remerge()
+        m_leafHulls = m_convexHulls;
+        m_convexHulls.Resize(0);
         MergeConvexHulls(params);
-        SimplifyConvexHulls(params);
+        CopyMergedHulls(params.m_maxConvexHulls, m_convexHulls);
+        SimplifyConvexHulls(&m_convexHulls, 1, params);
+        ResetArenas(params);
         if (params.m_oclAcceleration) {
             // Release kernels
         }
@@ -341,7 +594,12 @@ private:
 
 private:
 	RaycastMesh		*mRaycastMesh{ nullptr };
-    SArray<Mesh*> m_convexHulls;
+    SArray<ConvexHullMesh*> m_convexHulls;
+    SArray<ConvexHullMesh*> m_leafHulls; // convex-hulls of the decomposition, before merging
+    std::vector<HullMergeRecord> m_mergeHistory; // merges applied to the leaf hulls, in order
+    double m_mergeTolerance; // sparse merge tolerance reached at the end of the history
+    std::vector<SArray<ConvexHullMesh*> > m_lodConvexHulls; // convex-hulls of each level of detail of ComputeLODs
+    Parameters m_params; // parameters of the last Compute, used by Remerge
     std::string m_stage;
     std::string m_operation;
     double m_overallProgress;
@@ -352,11 +610,24 @@ private:
     Vec3<double> m_barycenter;
     Timer m_timer;
     size_t m_dim;
+    size_t m_nEvaluatedPlanes;
+    size_t m_nScreenedPlanes;
+    int32_t m_maxBestPlaneProxyRank;
     Volume* m_volume;
     PrimitiveSet* m_pset;
-    Mutex m_cancelMutex;
-    bool m_cancel;
+    std::atomic<bool> m_cancel;
     int32_t m_ompNumProcessors;
+    PlaneEvaluationWorkspace* m_workspaces; // one per thread
+    PrimitiveSet* m_onSurfacePSet;
+    Arena* m_arenas; // one per thread, for the temporaries of the decomposition
+    // buffers of the clipping plane searches, kept from one call to the next
+    SArray<double> m_proxyCosts; // screening: proxy costs of the planes
+    std::vector<int32_t> m_proxyRanking; // screening: planes by increasing proxy cost
+    Array<Plane> m_screenedPlanes; // screening: planes evaluated with exact convex-hulls
+    Array<Plane> m_searchPlanes; // adaptive search: planes of the current pass
+    SArray<double> m_searchCosts; // adaptive search: costs of the planes of the current pass
+    SArray<double> m_searchExactCosts[3]; // adaptive search: exact costs, per axis and plane index
+    SArray<PlaneSearchBracket> m_searchBrackets; // adaptive search: intervals refined
 #ifdef CL_VERSION_1_1
     cl_device_id* m_oclDevice;
     cl_context m_oclContext;
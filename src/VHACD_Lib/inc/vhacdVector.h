@@ -33,7 +33,8 @@ public:
     const T& Z() const;
     void Normalize();
     T GetNorm() const;
-    void operator=(const Vec3& rhs);
+    // trivial copies, so that arrays of vectors can be moved with memcpy/realloc
+    Vec3& operator=(const Vec3& rhs) = default;
     void operator+=(const Vec3& rhs);
     void operator-=(const Vec3& rhs);
     void operator-=(T a);
@@ -52,8 +53,8 @@ public:
     Vec3();
     Vec3(T a);
     Vec3(T x, T y, T z);
-    Vec3(const Vec3& rhs);
-    /*virtual*/ ~Vec3(void);
+    Vec3(const Vec3& rhs) = default;
+    ~Vec3(void) = default;
 
     // Compute the center of this bounding box and return the diagonal length
     T GetCenter(const Vec3 &bmin, const Vec3 &bmax)
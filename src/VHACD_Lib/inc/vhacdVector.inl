@@ -50,13 +50,6 @@ namespace VHACD
         return sqrt(m_data[0]*m_data[0]+m_data[1]*m_data[1]+m_data[2]*m_data[2]);
     }
     template <typename T> 
-    inline  void Vec3<T>::operator= (const Vec3 & rhs)
-    { 
-        this->m_data[0] = rhs.m_data[0]; 
-        this->m_data[1] = rhs.m_data[1]; 
-        this->m_data[2] = rhs.m_data[2]; 
-    }
-    template <typename T> 
     inline  void Vec3<T>::operator+=(const Vec3 & rhs)
     { 
         this->m_data[0] += rhs.m_data[0]; 
@@ -148,15 +141,6 @@ namespace VHACD
         m_data[1] = y;
         m_data[2] = z;
     }
-    template <typename T>
-    inline Vec3<T>::Vec3(const Vec3 & rhs)
-    {        
-        m_data[0] = rhs.m_data[0];
-        m_data[1] = rhs.m_data[1];
-        m_data[2] = rhs.m_data[2];
-    }
-    template <typename T>
-    inline Vec3<T>::~Vec3(void){};
 
     template <typename T>
     inline Vec3<T>::Vec3() {}
@@ -58,7 +58,8 @@ public:
     virtual void ComputeClippedVolumes(const Plane& plane, double& positiveVolume,
         double& negativeVolume) const = 0;
     virtual void SelectOnSurface(PrimitiveSet* const onSurfP) const = 0;
-    virtual void ComputeConvexHull(Mesh& meshCH, const size_t sampling = 1) const = 0;
+    virtual void ComputeConvexHull(Mesh& meshCH, const size_t sampling = 1,
+        btConvexHullComputer* const hullComputer = 0) const = 0; // hullComputer: optional, reused working memory
     virtual void ComputeBB() = 0;
     virtual void ComputePrincipalAxes() = 0;
     virtual void AlignToPrincipalAxes() = 0;
@@ -66,12 +67,16 @@ public:
     virtual void Convert(Mesh& mesh, const VOXEL_VALUE value) const = 0;
     const Mesh& GetConvexHull() const { return m_convexHull; };
     Mesh& GetConvexHull() { return m_convexHull; };
+    //! Sets the memory source of the primitives and convex-hull of this set, which are removed. The sets returned by
+    //! Create() use the same one.
+    virtual void SetAllocator(Allocator* const allocator) { m_convexHull.SetAllocator(allocator); }
+    Allocator* GetAllocator() const { return m_convexHull.GetAllocator(); }
 private:
     Mesh m_convexHull;
 };
 
 //!
-class VoxelSet : public PrimitiveSet {
+class VoxelSet final : public PrimitiveSet {
     friend class Volume;
 
 public:
@@ -110,20 +115,49 @@ public:
             voxel[2] * m_scale + m_minBB[2]);
     }
     void GetPoints(const Voxel& voxel, Vec3<double>* const pts) const;
-    void ComputeConvexHull(Mesh& meshCH, const size_t sampling = 1) const;
+    void ComputeConvexHull(Mesh& meshCH, const size_t sampling = 1, btConvexHullComputer* const hullComputer = 0) const;
     void Clip(const Plane& plane, PrimitiveSet* const positivePart, PrimitiveSet* const negativePart) const;
     void Intersect(const Plane& plane, SArray<Vec3<double> >* const positivePts,
         SArray<Vec3<double> >* const negativePts, const size_t sampling) const;
     void ComputeExteriorPoints(const Plane& plane, const Mesh& mesh,
         SArray<Vec3<double> >* const exteriorPts) const;
-    void ComputeClippedVolumes(const Plane& plane, double& positiveVolume, double& negativeVolume) const;
+    // defined inline, so that the specialized plane evaluation loop can inline and vectorize it
+    void ComputeClippedVolumes(const Plane& plane, double& positiveVolume, double& negativeVolume) const
+    {
+        negativeVolume = 0.0;
+        positiveVolume = 0.0;
+        const size_t nVoxels = m_voxels.Size();
+        if (nVoxels == 0)
+            return;
+        const Voxel* const voxels = m_voxels.Data();
+        // plane equation expressed in voxel coordinates
+        const double a = plane.m_a * m_scale;
+        const double b = plane.m_b * m_scale;
+        const double c = plane.m_c * m_scale;
+        const double d = plane.m_a * m_minBB[0] + plane.m_b * m_minBB[1] + plane.m_c * m_minBB[2] + plane.m_d;
+        size_t nPositiveVoxels = 0;
+        for (size_t v = 0; v < nVoxels; ++v) {
+            const short* const coord = voxels[v].m_coord;
+            nPositiveVoxels += (a * coord[0] + b * coord[1] + c * coord[2] + d >= 0.0);
+        }
+        size_t nNegativeVoxels = nVoxels - nPositiveVoxels;
+        positiveVolume = m_unitVolume * nPositiveVoxels;
+        negativeVolume = m_unitVolume * nNegativeVoxels;
+    }
     void SelectOnSurface(PrimitiveSet* const onSurfP) const;
     void ComputeBB();
     void Convert(Mesh& mesh, const VOXEL_VALUE value) const;
     void ComputePrincipalAxes();
     PrimitiveSet* Create() const
     {
-        return new VoxelSet();
+        VoxelSet* const vset = new VoxelSet();
+        vset->SetAllocator(GetAllocator());
+        return vset;
+    }
+    void SetAllocator(Allocator* const allocator)
+    {
+        PrimitiveSet::SetAllocator(allocator);
+        m_voxels.SetAllocator(allocator);
     }
     void AlignToPrincipalAxes(){};
     void RevertAlignToPrincipalAxes(){};
@@ -131,11 +165,13 @@ public:
     const Voxel* const GetVoxels() const { return m_voxels.Data(); }
 
 private:
+    bool ComputeLatticeConvexHull(Mesh& meshCH, const size_t sampling, btConvexHullComputer& ch) const;
+
     size_t m_numVoxelsOnSurface;
     size_t m_numVoxelsInsideSurface;
     Vec3<double> m_minBB;
     double m_scale;
-    SArray<Voxel, 8> m_voxels;
+    Array<Voxel> m_voxels;
     double m_unitVolume;
     Vec3<double> m_minBBPts;
     Vec3<double> m_maxBBPts;
@@ -154,7 +190,7 @@ public:
 };
 
 //!
-class TetrahedronSet : public PrimitiveSet {
+class TetrahedronSet final : public PrimitiveSet {
     friend class Volume;
 
 public:
@@ -173,7 +209,7 @@ public:
     const double GetSacle() const { return m_scale; }
     const double ComputeVolume() const;
     const double ComputeMaxVolumeError() const;
-    void ComputeConvexHull(Mesh& meshCH, const size_t sampling = 1) const;
+    void ComputeConvexHull(Mesh& meshCH, const size_t sampling = 1, btConvexHullComputer* const hullComputer = 0) const;
     void ComputePrincipalAxes();
     void AlignToPrincipalAxes();
     void RevertAlignToPrincipalAxes();
@@ -189,7 +225,14 @@ public:
     inline bool Add(Tetrahedron& tetrahedron);
     PrimitiveSet* Create() const
     {
-        return new TetrahedronSet();
+        TetrahedronSet* const tset = new TetrahedronSet();
+        tset->SetAllocator(GetAllocator());
+        return tset;
+    }
+    void SetAllocator(Allocator* const allocator)
+    {
+        PrimitiveSet::SetAllocator(allocator);
+        m_tetrahedra.SetAllocator(allocator);
     }
     static const double EPS;
 
@@ -202,7 +245,7 @@ private:
     Vec3<double> m_minBB;
     Vec3<double> m_maxBB;
     Vec3<double> m_barycenter;
-    SArray<Tetrahedron, 8> m_tetrahedra;
+    Array<Tetrahedron> m_tetrahedra;
     double m_Q[3][3];
     double m_D[3][3];
 };
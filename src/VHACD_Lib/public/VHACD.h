@@ -90,6 +90,13 @@ public:
             m_oclAcceleration = true;
             m_maxConvexHulls = 1024;
 			m_projectHullVertices = true; // This will project the output convex hull vertices onto the original source mesh to increase the floating point accuracy of the results
+			m_maxExactClippingPlanes = 0; // If non-zero, candidate clipping planes are first ranked with a cheap convex-hull volume proxy (hull of the k-DOP extreme points) and exact convex-hulls are only computed for this many best ranked planes. With 'm_adaptivePlaneSearch', the coarse planes are ranked with the proxy instead and the refinement stops after this many exact convex-hulls
+			m_sparseHullMerge = false; // If true, only convex hulls whose bounding boxes overlap (within 'm_mergeAABBTolerance') are considered for merging, instead of all the pairs of hulls
+			m_mergeAABBTolerance = 0.01; // Bounding box enlargement used by the sparse merge, as a fraction of the diagonal of the bounding box of all the convex hulls
+			m_lazyHullMerge = false; // If true, merge candidates are queued with a cheap lower bound of their cost and the exact convex hull of the union is only computed when a candidate reaches the top of the queue
+			m_adaptivePlaneSearch = false; // If true, the clipping plane search evaluates a coarse set of planes and only refines the most promising intervals (golden-section search) instead of uniformly sampling every 'm_planeDownsampling'-th plane
+			m_floatingPointHulls = false; // If true, convex hulls are first computed with a floating-point Quickhull using certified orientation tests, falling back to the exact convex hull computer when a test is inconclusive, and the convex hulls of voxels are computed exactly on the lattice of their corners. The hull vertices are then the input points themselves instead of their quantized positions
+			m_filterHullPoints = false; // If true, the points strictly inside the polytope of their extreme points along 13 fixed directions are discarded before each convex hull is computed. The hulls keep their vertices, but their order can change, and with it the simplified and merged hulls
         }
         double m_concavity;
         double m_alpha;
@@ -107,6 +114,13 @@ public:
         uint32_t m_oclAcceleration;
         uint32_t	m_maxConvexHulls;
 		bool	m_projectHullVertices;
+		bool	m_adaptivePlaneSearch;
+		uint32_t	m_maxExactClippingPlanes;
+		bool	m_sparseHullMerge;
+		double	m_mergeAABBTolerance;
+		bool	m_lazyHullMerge;
+		bool	m_floatingPointHulls;
+		bool	m_filterHullPoints;
     };
 
     virtual void Cancel() = 0;
@@ -122,6 +136,20 @@ public:
         const uint32_t countTriangles,
         const Parameters& params)
         = 0;
+    // Merges the convex hulls of the decomposition computed by the last 'Compute' call down to 'maxConvexHulls'
+    // hulls, without recomputing the decomposition. The merges are recorded, so changing the hull count back and
+    // forth replays them instead of evaluating them again. The other parameters of the last 'Compute' call, including
+    // its callback and logger, are reused. Returns false if there is no decomposition or the operation was canceled.
+    virtual bool Remerge(const uint32_t maxConvexHulls) = 0;
+    // Computes several levels of detail of the decomposition computed by the last 'Compute' call in a single merge
+    // pass: the hulls are merged down to the smallest of the 'nLODs' counts in 'maxConvexHulls', and the hull set is
+    // snapshotted when it reaches each of them. LOD 'i' has at most 'maxConvexHulls[i]' hulls, and every LOD is
+    // simplified like the regular output, which is left unchanged. 'Compute' should be called with the largest count,
+    // the decomposition depth being derived from it. Returns false if there is no decomposition or the operation was canceled.
+    virtual bool ComputeLODs(const uint32_t* const maxConvexHulls, const uint32_t nLODs) = 0;
+    virtual uint32_t GetNLODs() const = 0;
+    virtual uint32_t GetNLODConvexHulls(const uint32_t lod) const = 0;
+    virtual void GetLODConvexHull(const uint32_t lod, const uint32_t index, ConvexHull& ch) const = 0;
     virtual uint32_t GetNConvexHulls() const = 0;
     virtual void GetConvexHull(const uint32_t index, ConvexHull& ch) const = 0;
     virtual void Clean(void) = 0; // release internally allocated memory
@@ -135,6 +163,11 @@ public:
 	// in 'centerOfMass'.  Returns false if the center of mass could not be computed.
 	virtual bool ComputeCenterOfMass(double centerOfMass[3]) const = 0;
 
+	// Number of clipping planes whose cost was computed with exact convex hulls by the last 'Compute' call, and
+	// number of clipping planes ranked with the convex-hull volume proxy (see 'm_maxExactClippingPlanes').
+	virtual uint32_t GetNEvaluatedClippingPlanes() const = 0;
+	virtual uint32_t GetNScreenedClippingPlanes() const = 0;
+
 	// In synchronous mode (non-multi-threaded) the state is always 'ready'
 	// In asynchronous mode, this returns true if the background thread is not still actively computing
 	// a new solution.  In an asynchronous config the 'IsReady' call will report any update or log
@@ -6,6 +6,7 @@
 #include <atomic>
 #include <mutex>
 #include <string>
+#include <vector>
 #include <float.h>
 
 #define ENABLE_ASYNC 1
@@ -84,35 +85,107 @@ public:
 			bool ok = mVHACD->Compute(points, countPoints, triangles, countTriangles, desc);
 			if (ok)
 			{
-				ret = mVHACD->GetNConvexHulls();
-				mHulls = new IVHACD::ConvexHull[ret];
-				for (uint32_t i = 0; i < ret; i++)
+				ret = copyHulls();
+			}
+		}
+
+		mHullCount = ret;
+		return ret ? true : false;
+	}
+
+	uint32_t copyHulls(void) // copy the hulls of the base VHACD, so they can be queried while it runs again
+	{
+		uint32_t ret = mVHACD->GetNConvexHulls();
+		mHulls = new IVHACD::ConvexHull[ret];
+		for (uint32_t i = 0; i < ret; i++)
+		{
+			VHACD::IVHACD::ConvexHull vhull;
+			mVHACD->GetConvexHull(i, vhull);
+			copyHull(vhull, mHulls[i]);
+			if (mCancel)
+			{
+				ret = 0;
+				break;
+			}
+		}
+		return ret;
+	}
+
+	void copyHull(const VHACD::IVHACD::ConvexHull &vhull, VHACD::IVHACD::ConvexHull &h)
+	{
+		h.m_nPoints = vhull.m_nPoints;
+		h.m_points = (double *)HACD_ALLOC(sizeof(double) * 3 * h.m_nPoints);
+		memcpy(h.m_points, vhull.m_points, sizeof(double) * 3 * h.m_nPoints);
+		h.m_nTriangles = vhull.m_nTriangles;
+		h.m_triangles = (uint32_t *)HACD_ALLOC(sizeof(uint32_t) * 3 * h.m_nTriangles);
+		memcpy(h.m_triangles, vhull.m_triangles, sizeof(uint32_t) * 3 * h.m_nTriangles);
+		h.m_volume = vhull.m_volume;
+		h.m_center[0] = vhull.m_center[0];
+		h.m_center[1] = vhull.m_center[1];
+		h.m_center[2] = vhull.m_center[2];
+	}
+
+	// Re-merging only takes milliseconds, so it is done synchronously, once the decomposition is complete
+	virtual bool Remerge(const uint32_t maxConvexHulls) final
+	{
+		if (mRunning)
+		{
+			return false;
+		}
+		releaseHulls();
+		uint32_t ret = 0;
+		if (mVHACD->Remerge(maxConvexHulls))
+		{
+			ret = copyHulls();
+		}
+		mHullCount = ret;
+		processPendingMessages();
+		return ret ? true : false;
+	}
+
+	// Like re-merging, the levels of detail are computed synchronously, once the decomposition is complete
+	virtual bool ComputeLODs(const uint32_t* const maxConvexHulls, const uint32_t nLODs) final
+	{
+		if (mRunning)
+		{
+			return false;
+		}
+		releaseLODs();
+		bool ok = mVHACD->ComputeLODs(maxConvexHulls, nLODs);
+		if (ok)
+		{
+			mLODHulls.resize(mVHACD->GetNLODs());
+			for (uint32_t l = 0; l < mLODHulls.size(); l++)
+			{
+				mLODHulls[l].resize(mVHACD->GetNLODConvexHulls(l));
+				for (uint32_t i = 0; i < mLODHulls[l].size(); i++)
 				{
 					VHACD::IVHACD::ConvexHull vhull;
-					mVHACD->GetConvexHull(i, vhull);
-					VHACD::IVHACD::ConvexHull h;
-					h.m_nPoints = vhull.m_nPoints;
-					h.m_points = (double *)HACD_ALLOC(sizeof(double) * 3 * h.m_nPoints);
-					memcpy(h.m_points, vhull.m_points, sizeof(double) * 3 * h.m_nPoints);
-					h.m_nTriangles = vhull.m_nTriangles;
-					h.m_triangles = (uint32_t *)HACD_ALLOC(sizeof(uint32_t) * 3 * h.m_nTriangles);
-					memcpy(h.m_triangles, vhull.m_triangles, sizeof(uint32_t) * 3 * h.m_nTriangles);
-					h.m_volume = vhull.m_volume;
-					h.m_center[0] = vhull.m_center[0];
-					h.m_center[1] = vhull.m_center[1];
-					h.m_center[2] = vhull.m_center[2];
-					mHulls[i] = h;
-					if (mCancel)
-					{
-						ret = 0;
-						break;
-					}
+					mVHACD->GetLODConvexHull(l, i, vhull);
+					copyHull(vhull, mLODHulls[l][i]);
 				}
 			}
 		}
+		processPendingMessages();
+		return ok;
+	}
 
-		mHullCount = ret;
-		return ret ? true : false;
+	virtual uint32_t GetNLODs() const final
+	{
+		return (uint32_t)mLODHulls.size();
+	}
+
+	virtual uint32_t GetNLODConvexHulls(const uint32_t lod) const final
+	{
+		return lod < mLODHulls.size() ? (uint32_t)mLODHulls[lod].size() : 0;
+	}
+
+	virtual void GetLODConvexHull(const uint32_t lod, const uint32_t index, VHACD::IVHACD::ConvexHull& ch) const final
+	{
+		if (lod < mLODHulls.size() && index < mLODHulls[lod].size())
+		{
+			ch = mLODHulls[lod][index];
+		}
 	}
 
 	void releaseHull(VHACD::IVHACD::ConvexHull &h)
@@ -131,7 +204,7 @@ public:
 		}
 	}
 
-	void	releaseHACD(void) // release memory associated with the last HACD request
+	void	releaseHulls(void)
 	{
 		for (uint32_t i=0; i<mHullCount; i++)
 		{
@@ -140,6 +213,24 @@ public:
 		delete[]mHulls;
 		mHulls = nullptr;
 		mHullCount = 0;
+	}
+
+	void	releaseLODs(void)
+	{
+		for (uint32_t l = 0; l < mLODHulls.size(); l++)
+		{
+			for (uint32_t i = 0; i < mLODHulls[l].size(); i++)
+			{
+				releaseHull(mLODHulls[l][i]);
+			}
+		}
+		mLODHulls.clear();
+	}
+
+	void	releaseHACD(void) // release memory associated with the last HACD request
+	{
+		releaseHulls();
+		releaseLODs();
 		HACD_FREE(mVertices);
 		mVertices = nullptr;
 		HACD_FREE(mIndices);
@@ -296,11 +387,22 @@ public:
 		return ret;
 	}
 
+	virtual uint32_t GetNEvaluatedClippingPlanes() const final
+	{
+		return (mVHACD && IsReady()) ? mVHACD->GetNEvaluatedClippingPlanes() : 0;
+	}
+
+	virtual uint32_t GetNScreenedClippingPlanes() const final
+	{
+		return (mVHACD && IsReady()) ? mVHACD->GetNScreenedClippingPlanes() : 0;
+	}
+
 private:
 	double							*mVertices{ nullptr };
 	uint32_t						*mIndices{ nullptr };
 	std::atomic< uint32_t>			mHullCount{ 0 };
 	VHACD::IVHACD::ConvexHull		*mHulls{ nullptr };
+	std::vector< std::vector< VHACD::IVHACD::ConvexHull > >	mLODHulls; // copies of the levels of detail of the last ComputeLODs
 	VHACD::IVHACD::IUserCallback	*mCallback{ nullptr };
 	VHACD::IVHACD::IUserLogger		*mLogger{ nullptr };
 	VHACD::IVHACD					*mVHACD{ nullptr };
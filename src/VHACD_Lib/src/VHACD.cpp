@@ -19,16 +19,21 @@
 
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <limits>
+#include <queue>
 #include <sstream>
+#include <utility>
 #if _OPENMP
 #include <omp.h>
 #endif // _OPENMP
 
 #include "../public/VHACD.h"
 #include "btConvexHullComputer.h"
+#include "vhacdHullPointFilter.h"
 #include "vhacdICHull.h"
+#include "vhacdPointWelder.h"
 #include "vhacdMesh.h"
 #include "vhacdSArray.h"
 #include "vhacdTimer.h"
@@ -41,97 +46,13 @@
 #define MIN(a, b) (((a) < (b)) ? (a) : (b))
 #define ABS(a) (((a) < 0) ? -(a) : (a))
 #define ZSGN(a) (((a) < 0) ? -1 : (a) > 0 ? 1 : 0)
-#define MAX_DOUBLE (1.79769e+308)
+// downsampling of the points added to the convex-hulls of the clipped parts, relative to the convex-hull downsampling
+#define CLIPPED_HULL_DOWNSAMPLING_SCALE 32
 
 #ifdef _MSC_VER
 #pragma warning(disable:4267 4100 4244 4456)
 #endif
 
-#ifdef USE_SSE
-#include <immintrin.h>
-
-const int32_t SIMD_WIDTH = 4;
-inline int32_t FindMinimumElement(const float* const d, float* const _, const int32_t n)
-{
-    // Min within vectors
-    __m128 min_i = _mm_set1_ps(-1.0f);
-    __m128 min_v = _mm_set1_ps(std::numeric_limits<float>::max());
-    for (int32_t i = 0; i <= n - SIMD_WIDTH; i += SIMD_WIDTH) {
-        const __m128 data = _mm_load_ps(&d[i]);
-        const __m128 pred = _mm_cmplt_ps(data, min_v);
-
-        min_i = _mm_blendv_ps(min_i, _mm_set1_ps(i), pred);
-        min_v = _mm_min_ps(data, min_v);
-    }
-
-    /* Min within vector */
-    const __m128 min1 = _mm_shuffle_ps(min_v, min_v, _MM_SHUFFLE(1, 0, 3, 2));
-    const __m128 min2 = _mm_min_ps(min_v, min1);
-    const __m128 min3 = _mm_shuffle_ps(min2, min2, _MM_SHUFFLE(0, 1, 0, 1));
-    const __m128 min4 = _mm_min_ps(min2, min3);
-    float min_d = _mm_cvtss_f32(min4);
-
-    // Min index
-    const int32_t min_idx = __builtin_ctz(_mm_movemask_ps(_mm_cmpeq_ps(min_v, min4)));
-    int32_t ret = min_i[min_idx] + min_idx;
-
-    // Trailing elements
-    for (int32_t i = (n & ~(SIMD_WIDTH - 1)); i < n; ++i) {
-        if (d[i] < min_d) {
-            min_d = d[i];
-            ret = i;
-        }
-    }
-
-    *m = min_d;
-    return ret;
-}
-
-inline int32_t FindMinimumElement(const float* const d, float* const m, const int32_t begin, const int32_t end)
-{
-    // Leading elements
-    int32_t min_i = -1;
-    float min_d = std::numeric_limits<float>::max();
-    const int32_t aligned = (begin & ~(SIMD_WIDTH - 1)) + ((begin & (SIMD_WIDTH - 1)) ? SIMD_WIDTH : 0);
-    for (int32_t i = begin; i < std::min(end, aligned); ++i) {
-        if (d[i] < min_d) {
-            min_d = d[i];
-            min_i = i;
-        }
-    }
-
-    // Middle and trailing elements
-    float r_m = std::numeric_limits<float>::max();
-    const int32_t n = end - aligned;
-    const int32_t r_i = (n > 0) ? FindMinimumElement(&d[aligned], &r_m, n) : 0;
-
-    // Pick the lowest
-    if (r_m < min_d) {
-        *m = r_m;
-        return r_i + aligned;
-    }
-    else {
-        *m = min_d;
-        return min_i;
-    }
-}
-#else
-inline int32_t FindMinimumElement(const float* const d, float* const m, const int32_t begin, const int32_t end)
-{
-    int32_t idx = -1;
-    float min = (std::numeric_limits<float>::max)();
-    for (size_t i = begin; i < size_t(end); ++i) {
-        if (d[i] < min) {
-            idx = i;
-            min = d[i];
-        }
-    }
-
-    *m = min;
-    return idx;
-}
-#endif
-
 //#define OCL_SOURCE_FROM_FILE
 #ifndef OCL_SOURCE_FROM_FILE
 const char* oclProgramSource = "\
@@ -411,11 +332,13 @@ void VHACD::ComputePrimitiveSet(const Parameters& params)
     Update(0.0, 0.0, params);
     if (params.m_mode == 0) {
         VoxelSet* vset = new VoxelSet;
+        vset->SetAllocator(&m_arenas[0]);
         m_volume->Convert(*vset);
         m_pset = vset;
     }
     else {
         TetrahedronSet* tset = new TetrahedronSet;
+        tset->SetAllocator(&m_arenas[0]);
         m_volume->Convert(*tset);
         m_pset = tset;
     }
@@ -480,7 +403,7 @@ double ComputePreferredCuttingDirection(const PrimitiveSet* const tset, Vec3<dou
         return (e == 0.0) ? 0.0 : 1.0 - vz / e;
     }
 }
-void ComputeAxesAlignedClippingPlanes(const VoxelSet& vset, const short downsampling, SArray<Plane>& planes)
+void ComputeAxesAlignedClippingPlanes(const VoxelSet& vset, const short downsampling, Array<Plane>& planes)
 {
     const Vec3<short> minV = vset.GetMinBBVoxels();
     const Vec3<short> maxV = vset.GetMaxBBVoxels();
@@ -523,7 +446,7 @@ void ComputeAxesAlignedClippingPlanes(const VoxelSet& vset, const short downsamp
         planes.PushBack(plane);
     }
 }
-void ComputeAxesAlignedClippingPlanes(const TetrahedronSet& tset, const short downsampling, SArray<Plane>& planes)
+void ComputeAxesAlignedClippingPlanes(const TetrahedronSet& tset, const short downsampling, Array<Plane>& planes)
 {
     const Vec3<double> minV = tset.GetMinBB();
     const Vec3<double> maxV = tset.GetMaxBB();
@@ -568,7 +491,7 @@ void ComputeAxesAlignedClippingPlanes(const TetrahedronSet& tset, const short do
     }
 }
 void RefineAxesAlignedClippingPlanes(const VoxelSet& vset, const Plane& bestPlane, const short downsampling,
-    SArray<Plane>& planes)
+    Array<Plane>& planes)
 {
     const Vec3<short> minV = vset.GetMinBBVoxels();
     const Vec3<short> maxV = vset.GetMaxBBVoxels();
@@ -619,7 +542,7 @@ void RefineAxesAlignedClippingPlanes(const VoxelSet& vset, const Plane& bestPlan
     }
 }
 void RefineAxesAlignedClippingPlanes(const TetrahedronSet& tset, const Plane& bestPlane, const short downsampling,
-    SArray<Plane>& planes)
+    Array<Plane>& planes)
 {
     const Vec3<double> minV = tset.GetMinBB();
     const Vec3<double> maxV = tset.GetMaxBB();
@@ -669,6 +592,35 @@ void RefineAxesAlignedClippingPlanes(const TetrahedronSet& tset, const Plane& be
         }
     }
 }
+void GetAxesAlignedClippingPlanesRange(const VoxelSet& vset, const AXIS axis, short& i0, short& i1)
+{
+    i0 = vset.GetMinBBVoxels()[axis];
+    i1 = vset.GetMaxBBVoxels()[axis];
+}
+void GetAxesAlignedClippingPlanesRange(const TetrahedronSet& tset, const AXIS axis, short& i0, short& i1)
+{
+    i0 = 0;
+    i1 = static_cast<short>((tset.GetMaxBB()[axis] - tset.GetMinBB()[axis]) / tset.GetSacle() + 0.5);
+}
+void ComputeAxesAlignedClippingPlane(const VoxelSet& vset, const AXIS axis, const short index, Plane& plane)
+{
+    const Vec3<double> pt = vset.GetPoint(Vec3<double>(index + 0.5, index + 0.5, index + 0.5));
+    plane.m_a = (axis == AXIS_X) ? 1.0 : 0.0;
+    plane.m_b = (axis == AXIS_Y) ? 1.0 : 0.0;
+    plane.m_c = (axis == AXIS_Z) ? 1.0 : 0.0;
+    plane.m_d = -pt[axis];
+    plane.m_axis = axis;
+    plane.m_index = index;
+}
+void ComputeAxesAlignedClippingPlane(const TetrahedronSet& tset, const AXIS axis, const short index, Plane& plane)
+{
+    plane.m_a = (axis == AXIS_X) ? 1.0 : 0.0;
+    plane.m_b = (axis == AXIS_Y) ? 1.0 : 0.0;
+    plane.m_c = (axis == AXIS_Z) ? 1.0 : 0.0;
+    plane.m_d = -(tset.GetMinBB()[axis] + tset.GetSacle() * index);
+    plane.m_axis = axis;
+    plane.m_index = index;
+}
 inline double ComputeLocalConcavity(const double volume, const double volumeCH)
 {
     return fabs(volumeCH - volume) / volumeCH;
@@ -678,58 +630,383 @@ inline double ComputeConcavity(const double volume, const double volumeCH, const
     return fabs(volumeCH - volume) / volume0;
 }
 
+// Directions of the 13-DOP (axes, face and body diagonals) used to select the extreme points of a point cloud
+static const int32_t g_nKDOPExtremePoints = 26;
+static const double g_kDOPDirections[13][3] = {
+    { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 },
+    { 1.0, 1.0, 0.0 }, { 1.0, -1.0, 0.0 }, { 1.0, 0.0, 1.0 },
+    { 1.0, 0.0, -1.0 }, { 0.0, 1.0, 1.0 }, { 0.0, 1.0, -1.0 },
+    { 1.0, 1.0, 1.0 }, { 1.0, 1.0, -1.0 }, { 1.0, -1.0, 1.0 },
+    { 1.0, -1.0, -1.0 }
+};
+// Keeps, for each k-DOP direction, the two points of pts with the smallest and largest projections.
+// Their convex-hull is inscribed in the convex-hull of pts and its volume is a cheap lower bound of it.
+void ComputeExtremePoints(const SArray<Vec3<double> >& pts, SArray<Vec3<double> >& extremePts)
+{
+    extremePts.Resize(0);
+    const size_t nPoints = pts.Size();
+    if (nPoints == 0) {
+        return;
+    }
+    size_t iMin[13];
+    size_t iMax[13];
+    double dMin[13];
+    double dMax[13];
+    for (int32_t k = 0; k < 13; ++k) {
+        iMin[k] = iMax[k] = 0;
+        dMin[k] = dMax[k] = g_kDOPDirections[k][0] * pts[0][0] + g_kDOPDirections[k][1] * pts[0][1] + g_kDOPDirections[k][2] * pts[0][2];
+    }
+    for (size_t i = 1; i < nPoints; ++i) {
+        const Vec3<double>& pt = pts[i];
+        for (int32_t k = 0; k < 13; ++k) {
+            const double d = g_kDOPDirections[k][0] * pt[0] + g_kDOPDirections[k][1] * pt[1] + g_kDOPDirections[k][2] * pt[2];
+            if (d < dMin[k]) {
+                dMin[k] = d;
+                iMin[k] = i;
+            }
+            else if (d > dMax[k]) {
+                dMax[k] = d;
+                iMax[k] = i;
+            }
+        }
+    }
+    for (int32_t k = 0; k < 13; ++k) {
+        extremePts.PushBack(pts[iMin[k]]);
+        extremePts.PushBack(pts[iMax[k]]);
+    }
+}
+// Orders plane indices by increasing proxy cost (ties broken by index to keep the selection deterministic)
+struct ProxyCostComparator {
+    const SArray<double>& m_costs;
+    ProxyCostComparator(const SArray<double>& costs)
+        : m_costs(costs)
+    {
+    }
+    bool operator()(const int32_t a, const int32_t b) const
+    {
+        return m_costs[a] < m_costs[b] || (m_costs[a] == m_costs[b] && a < b);
+    }
+};
+
+void VHACD::PreparePlaneEvaluationWorkspaces(const Parameters& params)
+{
+    for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+        m_workspaces[i].m_hullComputer.useQuickHull = params.m_floatingPointHulls;
+        m_workspaces[i].m_hullComputer.usePointFilter = params.m_filterHullPoints;
+        m_workspaces[i].m_hullComputer.getPointFilter().ResetCounters();
+    }
+    // the primitive sets of the workspaces match the primitive set type of the decomposition, and each thread's
+    // temporaries come from its own arena
+    ReleasePlaneEvaluationWorkspaces();
+    m_onSurfacePSet = m_pset->Create();
+    for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+        PlaneEvaluationWorkspace& workspace = m_workspaces[i];
+        workspace.m_left = m_pset->Create();
+        workspace.m_right = m_pset->Create();
+        workspace.m_left->SetAllocator(&m_arenas[i]);
+        workspace.m_right->SetAllocator(&m_arenas[i]);
+        workspace.m_leftCH.SetAllocator(&m_arenas[i]);
+        workspace.m_rightCH.SetAllocator(&m_arenas[i]);
+    }
+}
+void VHACD::ReleasePlaneEvaluationWorkspaces()
+{
+    delete m_onSurfacePSet;
+    m_onSurfacePSet = 0;
+    for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+        PlaneEvaluationWorkspace& workspace = m_workspaces[i];
+        delete workspace.m_left;
+        delete workspace.m_right;
+        workspace.m_left = 0;
+        workspace.m_right = 0;
+        workspace.m_leftCH.SetAllocator(0);
+        workspace.m_rightCH.SetAllocator(0);
+    }
+}
+void VHACD::ReleasePlaneSearchBuffers()
+{
+    m_proxyCosts.Clear();
+    std::vector<int32_t>().swap(m_proxyRanking);
+    m_screenedPlanes.Clear();
+    m_searchPlanes.Clear();
+    m_searchCosts.Clear();
+    for (int32_t a = 0; a < 3; ++a) {
+        m_searchExactCosts[a].Clear();
+    }
+    m_searchBrackets.Clear();
+}
+void VHACD::ResetArenas(const Parameters& params)
+{
+    // nothing allocated from the arenas may outlive them
+    ReleasePlaneEvaluationWorkspaces();
+    delete m_pset;
+    m_pset = 0;
+    size_t highWaterMark = 0;
+    size_t reservedBytes = 0;
+    size_t nAllocations = 0;
+    size_t nLiveBlocks = 0;
+    for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+        highWaterMark += m_arenas[i].GetHighWaterMark();
+        reservedBytes += m_arenas[i].GetReservedBytes();
+        nAllocations += m_arenas[i].GetNAllocations();
+        nLiveBlocks += m_arenas[i].GetNLiveBlocks();
+        m_arenas[i].Reset();
+    }
+    if (params.m_logger) {
+        std::ostringstream msg;
+        msg << "\t\t [Arena] high-water mark " << highWaterMark / 1024 << " KB, " << reservedBytes / 1024
+            << " KB reserved, " << nAllocations << " allocations" << std::endl;
+        if (nLiveBlocks) {
+            // the arenas holding them keep their chunks, so they stay valid
+            msg << "\t\t [Arena] " << nLiveBlocks << " blocks still in use, chunks not recycled" << std::endl;
+        }
+        params.m_logger->Log(msg.str().c_str());
+    }
+}
+#ifdef CL_VERSION_1_1
+void VHACD::EnqueueClippedVolumesOCL(const int32_t threadID, const Plane& plane, const OCLClippedVolumes& ocl, const Parameters& params)
+{
+    const float fPlane[4] = { (float)plane.m_a, (float)plane.m_b, (float)plane.m_c, (float)plane.m_d };
+    cl_int error = clSetKernelArg(m_oclKernelComputePartialVolumes[threadID], 2, sizeof(float) * 4, fPlane);
+    if (error != CL_SUCCESS) {
+        if (params.m_logger) {
+            params.m_logger->Log("Couldn't kernel atguments \n");
+        }
+        SetCancel(true);
+    }
+
+    size_t globalSize = ocl.m_globalSize;
+    error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputePartialVolumes[threadID],
+        1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
+    if (error != CL_SUCCESS) {
+        if (params.m_logger) {
+            params.m_logger->Log("Couldn't run kernel \n");
+        }
+        SetCancel(true);
+    }
+    int32_t nValues = (int32_t)ocl.m_nWorkGroups;
+    while (nValues > 1) {
+        error = clSetKernelArg(m_oclKernelComputeSum[threadID], 1, sizeof(int32_t), &nValues);
+        if (error != CL_SUCCESS) {
+            if (params.m_logger) {
+                params.m_logger->Log("Couldn't kernel atguments \n");
+            }
+            SetCancel(true);
+        }
+        size_t nWorkGroups = (nValues + m_oclWorkGroupSize - 1) / m_oclWorkGroupSize;
+        size_t globalSize = nWorkGroups * m_oclWorkGroupSize;
+        error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputeSum[threadID],
+            1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
+        if (error != CL_SUCCESS) {
+            if (params.m_logger) {
+                params.m_logger->Log("Couldn't run kernel \n");
+            }
+            SetCancel(true);
+        }
+        nValues = (int32_t)nWorkGroups;
+    }
+}
+void VHACD::ReadClippedVolumesOCL(const int32_t threadID, const OCLClippedVolumes& ocl, double& volumeRight,
+    double& volumeLeft, const Parameters& params)
+{
+    uint32_t volumes[4];
+    cl_int error = clEnqueueReadBuffer(m_oclQueue[threadID], ocl.m_partialVolumes[threadID], CL_TRUE,
+        0, sizeof(uint32_t) * 4, volumes, 0, NULL, NULL);
+    size_t nPrimitivesRight = volumes[0] + volumes[1] + volumes[2] + volumes[3];
+    size_t nPrimitivesLeft = ocl.m_nPrimitives - nPrimitivesRight;
+    volumeRight = nPrimitivesRight * ocl.m_unitVolume;
+    volumeLeft = nPrimitivesLeft * ocl.m_unitVolume;
+    if (error != CL_SUCCESS) {
+        if (params.m_logger) {
+            params.m_logger->Log("Couldn't read buffer \n");
+        }
+        SetCancel(true);
+    }
+}
+#endif // CL_VERSION_1_1
+// Plane loop of ComputeBestClippingPlane(), instantiated for each primitive set type and convex-hull approximation mode
+// so that the per-plane work calls the primitive set non-virtually and does not test the approximation mode
+template <class T, bool CH_APPROXIMATION>
+void VHACD::EvaluateClippingPlanes(const T* const inputPSet, const T* const onSurfacePSet, const Array<Plane>& planes,
+    const Vec3<double>& preferredCuttingDirection, const double w, const double alpha, const double beta,
+    const int32_t convexhullDownsampling, const double progress0, const double progress1, const bool oclAcceleration,
+    const OCLClippedVolumes& ocl, SArray<double>* const costs, const Parameters& params)
+{
+#ifndef CL_VERSION_1_1
+    (void)ocl;
+#endif // CL_VERSION_1_1
+    const int32_t nPlanes = static_cast<int32_t>(planes.Size());
+    std::atomic<int32_t> done(0);
+    int32_t reported = 0;
+#if USE_THREAD == 1 && _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int32_t x = 0; x < nPlanes; ++x) {
+        int32_t threadID = 0;
+#if USE_THREAD == 1 && _OPENMP
+        threadID = omp_get_thread_num();
+#endif
+        if (!GetCancel()) {
+            const Plane& plane = planes[x];
+
+#ifdef CL_VERSION_1_1
+            if (oclAcceleration) {
+                EnqueueClippedVolumesOCL(threadID, plane, ocl, params);
+            }
+#endif // CL_VERSION_1_1
+
+            // compute convex-hulls
+            PlaneEvaluationWorkspace& workspace = m_workspaces[threadID];
+            Mesh& leftCH = workspace.m_leftCH;
+            Mesh& rightCH = workspace.m_rightCH;
+            rightCH.ResizePoints(0);
+            leftCH.ResizePoints(0);
+            rightCH.ResizeTriangles(0);
+            leftCH.ResizeTriangles(0);
+            if (CH_APPROXIMATION) {
+                SArray<Vec3<double> >& leftCHPts = workspace.m_leftCHPts;
+                SArray<Vec3<double> >& rightCHPts = workspace.m_rightCHPts;
+                rightCHPts.Resize(0);
+                leftCHPts.Resize(0);
+                onSurfacePSet->Intersect(plane, &rightCHPts, &leftCHPts, convexhullDownsampling * CLIPPED_HULL_DOWNSAMPLING_SCALE);
+                inputPSet->GetConvexHull().Clip(plane, rightCHPts, leftCHPts);
+                rightCH.ComputeConvexHull((double*)rightCHPts.Data(), rightCHPts.Size(), &workspace.m_hullComputer);
+                leftCH.ComputeConvexHull((double*)leftCHPts.Data(), leftCHPts.Size(), &workspace.m_hullComputer);
+            }
+            else {
+                T* const right = static_cast<T*>(workspace.m_right);
+                T* const left = static_cast<T*>(workspace.m_left);
+                onSurfacePSet->Clip(plane, right, left);
+                right->ComputeConvexHull(rightCH, convexhullDownsampling, &workspace.m_hullComputer);
+                left->ComputeConvexHull(leftCH, convexhullDownsampling, &workspace.m_hullComputer);
+            }
+            double volumeLeftCH = leftCH.ComputeVolume();
+            double volumeRightCH = rightCH.ComputeVolume();
+
+            // compute clipped volumes
+            double volumeLeft = 0.0;
+            double volumeRight = 0.0;
+            if (oclAcceleration) {
+#ifdef CL_VERSION_1_1
+                ReadClippedVolumesOCL(threadID, ocl, volumeRight, volumeLeft, params);
+#endif // CL_VERSION_1_1
+            }
+            else {
+                inputPSet->ComputeClippedVolumes(plane, volumeRight, volumeLeft);
+            }
+            double concavityLeft = ComputeConcavity(volumeLeft, volumeLeftCH, m_volumeCH0);
+            double concavityRight = ComputeConcavity(volumeRight, volumeRightCH, m_volumeCH0);
+            double concavity = (concavityLeft + concavityRight);
+
+            // compute cost
+            double balance = alpha * fabs(volumeLeft - volumeRight) / m_volumeCH0;
+            double d = w * (preferredCuttingDirection[0] * plane.m_a + preferredCuttingDirection[1] * plane.m_b + preferredCuttingDirection[2] * plane.m_c);
+            double symmetry = beta * d;
+            double total = concavity + balance + symmetry;
+            if (costs) {
+                (*costs)[x] = total;
+            }
+
+            // ties are broken by plane index so that the result does not depend on the visiting order
+            if (total < workspace.m_minTotal || (total == workspace.m_minTotal && x < workspace.m_iBest)) {
+                workspace.m_minConcavity = concavity;
+                workspace.m_minBalance = balance;
+                workspace.m_minSymmetry = symmetry;
+                workspace.m_bestPlane = plane;
+                workspace.m_minTotal = total;
+                workspace.m_iBest = x;
+            }
+            UpdatePlaneProgress(done, reported, threadID, nPlanes, progress0, progress1, params);
+        }
+    }
+}
+
 //#define DEBUG_TEMP
-void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double volume, const SArray<Plane>& planes,
+void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double volume, const Array<Plane>& planes,
     const Vec3<double>& preferredCuttingDirection, const double w, const double alpha, const double beta,
     const int32_t convexhullDownsampling, const double progress0, const double progress1, Plane& bestPlane,
-    double& minConcavity, const Parameters& params)
+    double& minConcavity, const Parameters& params, SArray<double>* const costs)
 {
     if (GetCancel()) {
         return;
     }
     char msg[256];
+    const int32_t maxExactPlanes = static_cast<int32_t>(params.m_maxExactClippingPlanes);
+    if (!costs && maxExactPlanes > 0 && maxExactPlanes < static_cast<int32_t>(planes.Size())) {
+        // rank all the planes with the proxy cost and only compute exact convex-hulls for the best ones
+        // (callers asking for the costs need all of them, the adaptive search screens its planes itself)
+        const double progress = 0.5 * (progress0 + progress1);
+        SArray<double>& proxyCosts = m_proxyCosts;
+        ComputeClippingPlanesProxyCosts(inputPSet, planes, preferredCuttingDirection, w, alpha, beta,
+            convexhullDownsampling, progress0, progress, proxyCosts, params);
+        if (GetCancel()) {
+            return;
+        }
+        const int32_t nScreenedPlanes = static_cast<int32_t>(planes.Size());
+        std::vector<int32_t>& ranking = m_proxyRanking;
+        ranking.resize(nScreenedPlanes);
+        for (int32_t x = 0; x < nScreenedPlanes; ++x) {
+            ranking[x] = x;
+        }
+        std::partial_sort(ranking.begin(), ranking.begin() + maxExactPlanes, ranking.end(), ProxyCostComparator(proxyCosts));
+        Array<Plane>& candidates = m_screenedPlanes;
+        candidates.Resize(0);
+        for (int32_t k = 0; k < maxExactPlanes; ++k) {
+            candidates.PushBack(planes[ranking[k]]);
+        }
+        ComputeBestClippingPlane(inputPSet, volume, candidates, preferredCuttingDirection, w, alpha, beta,
+            convexhullDownsampling, progress, progress1, bestPlane, minConcavity, params);
+        int32_t bestRank = -1;
+        for (int32_t k = 0; k < maxExactPlanes && bestRank < 0; ++k) {
+            if (candidates[k].m_axis == bestPlane.m_axis && candidates[k].m_index == bestPlane.m_index) {
+                bestRank = k;
+            }
+        }
+        m_maxBestPlaneProxyRank = std::max(m_maxBestPlaneProxyRank, bestRank);
+        if (params.m_logger) {
+            sprintf(msg, "\t\t [Plane screening] %i proxy hulls, %i exact hulls, best plane proxy rank %i\n", nScreenedPlanes, maxExactPlanes, bestRank);
+            params.m_logger->Log(msg);
+        }
+        return;
+    }
     size_t nPrimitives = inputPSet->GetNPrimitives();
     bool oclAcceleration = (nPrimitives > OCL_MIN_NUM_PRIMITIVES && params.m_oclAcceleration && params.m_mode == 0) ? true : false;
     int32_t iBest = -1;
     int32_t nPlanes = static_cast<int32_t>(planes.Size());
-    bool cancel = false;
-    int32_t done = 0;
     double minTotal = MAX_DOUBLE;
     double minBalance = MAX_DOUBLE;
     double minSymmetry = MAX_DOUBLE;
     minConcavity = MAX_DOUBLE;
+    for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+        m_workspaces[i].ResetBestPlane();
+    }
+    m_nEvaluatedPlanes += nPlanes;
+    if (costs) {
+        costs->Resize(nPlanes);
+    }
 
-    SArray<Vec3<double> >* chPts = new SArray<Vec3<double> >[2 * m_ompNumProcessors];
-    Mesh* chs = new Mesh[2 * m_ompNumProcessors];
-    PrimitiveSet* onSurfacePSet = inputPSet->Create();
+    PrimitiveSet* const onSurfacePSet = m_onSurfacePSet;
     inputPSet->SelectOnSurface(onSurfacePSet);
 
-    PrimitiveSet** psets = 0;
-    if (!params.m_convexhullApproximation) {
-        psets = new PrimitiveSet*[2 * m_ompNumProcessors];
-        for (int32_t i = 0; i < 2 * m_ompNumProcessors; ++i) {
-            psets[i] = inputPSet->Create();
-        }
-    }
-
+    OCLClippedVolumes ocl;
 #ifdef CL_VERSION_1_1
     // allocate OpenCL data structures
-    cl_mem voxels;
-    cl_mem* partialVolumes = 0;
-    size_t globalSize = 0;
-    size_t nWorkGroups = 0;
-    double unitVolume = 0.0;
+    ocl.m_partialVolumes = 0;
+    ocl.m_globalSize = 0;
+    ocl.m_nWorkGroups = 0;
+    ocl.m_unitVolume = 0.0;
+    ocl.m_nPrimitives = nPrimitives;
     if (oclAcceleration) {
         VoxelSet* vset = (VoxelSet*)inputPSet;
         const Vec3<double> minBB = vset->GetMinBB();
         const float fMinBB[4] = { (float)minBB[0], (float)minBB[1], (float)minBB[2], 1.0f };
         const float fSclae[4] = { (float)vset->GetScale(), (float)vset->GetScale(), (float)vset->GetScale(), 0.0f };
         const int32_t nVoxels = (int32_t)nPrimitives;
-        unitVolume = vset->GetUnitVolume();
-        nWorkGroups = (nPrimitives + 4 * m_oclWorkGroupSize - 1) / (4 * m_oclWorkGroupSize);
-        globalSize = nWorkGroups * m_oclWorkGroupSize;
+        ocl.m_unitVolume = vset->GetUnitVolume();
+        ocl.m_nWorkGroups = (nPrimitives + 4 * m_oclWorkGroupSize - 1) / (4 * m_oclWorkGroupSize);
+        ocl.m_globalSize = ocl.m_nWorkGroups * m_oclWorkGroupSize;
         cl_int error;
-        voxels = clCreateBuffer(m_oclContext,
+        ocl.m_voxels = clCreateBuffer(m_oclContext,
             CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
             sizeof(Voxel) * nPrimitives,
             vset->GetVoxels(),
@@ -741,11 +1018,11 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
             SetCancel(true);
         }
 
-        partialVolumes = new cl_mem[m_ompNumProcessors];
+        ocl.m_partialVolumes = new cl_mem[m_ompNumProcessors];
         for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
-            partialVolumes[i] = clCreateBuffer(m_oclContext,
+            ocl.m_partialVolumes[i] = clCreateBuffer(m_oclContext,
                 CL_MEM_WRITE_ONLY,
-                sizeof(uint32_t) * 4 * nWorkGroups,
+                sizeof(uint32_t) * 4 * ocl.m_nWorkGroups,
                 NULL,
                 &error);
             if (error != CL_SUCCESS) {
@@ -755,13 +1032,13 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
                 SetCancel(true);
                 break;
             }
-            error = clSetKernelArg(m_oclKernelComputePartialVolumes[i], 0, sizeof(cl_mem), &voxels);
+            error = clSetKernelArg(m_oclKernelComputePartialVolumes[i], 0, sizeof(cl_mem), &ocl.m_voxels);
             error |= clSetKernelArg(m_oclKernelComputePartialVolumes[i], 1, sizeof(uint32_t), &nVoxels);
             error |= clSetKernelArg(m_oclKernelComputePartialVolumes[i], 3, sizeof(float) * 4, fMinBB);
             error |= clSetKernelArg(m_oclKernelComputePartialVolumes[i], 4, sizeof(float) * 4, &fSclae);
             error |= clSetKernelArg(m_oclKernelComputePartialVolumes[i], 5, sizeof(uint32_t) * 4 * m_oclWorkGroupSize, NULL);
-            error |= clSetKernelArg(m_oclKernelComputePartialVolumes[i], 6, sizeof(cl_mem), &(partialVolumes[i]));
-            error |= clSetKernelArg(m_oclKernelComputeSum[i], 0, sizeof(cl_mem), &(partialVolumes[i]));
+            error |= clSetKernelArg(m_oclKernelComputePartialVolumes[i], 6, sizeof(cl_mem), &(ocl.m_partialVolumes[i]));
+            error |= clSetKernelArg(m_oclKernelComputeSum[i], 0, sizeof(cl_mem), &(ocl.m_partialVolumes[i]));
             error |= clSetKernelArg(m_oclKernelComputeSum[i], 2, sizeof(uint32_t) * 4 * m_oclWorkGroupSize, NULL);
             if (error != CL_SUCCESS) {
                 if (params.m_logger) {
@@ -780,6 +1057,75 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
     timerComputeCost.Tic();
 #endif // DEBUG_TEMP
 
+    // select the specialized plane loop once, rather than testing the primitive type and approximation mode per plane
+    if (params.m_mode == 0) {
+        if (params.m_convexhullApproximation) {
+            EvaluateClippingPlanes<VoxelSet, true>((const VoxelSet*)inputPSet, (const VoxelSet*)onSurfacePSet, planes, preferredCuttingDirection,
+                w, alpha, beta, convexhullDownsampling, progress0, progress1, oclAcceleration, ocl, costs, params);
+        }
+        else {
+            EvaluateClippingPlanes<VoxelSet, false>((const VoxelSet*)inputPSet, (const VoxelSet*)onSurfacePSet, planes, preferredCuttingDirection,
+                w, alpha, beta, convexhullDownsampling, progress0, progress1, oclAcceleration, ocl, costs, params);
+        }
+    }
+    else {
+        if (params.m_convexhullApproximation) {
+            EvaluateClippingPlanes<TetrahedronSet, true>((const TetrahedronSet*)inputPSet, (const TetrahedronSet*)onSurfacePSet, planes, preferredCuttingDirection,
+                w, alpha, beta, convexhullDownsampling, progress0, progress1, oclAcceleration, ocl, costs, params);
+        }
+        else {
+            EvaluateClippingPlanes<TetrahedronSet, false>((const TetrahedronSet*)inputPSet, (const TetrahedronSet*)onSurfacePSet, planes, preferredCuttingDirection,
+                w, alpha, beta, convexhullDownsampling, progress0, progress1, oclAcceleration, ocl, costs, params);
+        }
+    }
+
+    // reduce the per-thread candidates (ties are broken by plane index to keep the result deterministic)
+    for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+        const PlaneEvaluationWorkspace& workspace = m_workspaces[i];
+        if (workspace.m_iBest >= 0 && (workspace.m_minTotal < minTotal || (workspace.m_minTotal == minTotal && workspace.m_iBest < iBest))) {
+            minConcavity = workspace.m_minConcavity;
+            minBalance = workspace.m_minBalance;
+            minSymmetry = workspace.m_minSymmetry;
+            bestPlane = workspace.m_bestPlane;
+            minTotal = workspace.m_minTotal;
+            iBest = workspace.m_iBest;
+        }
+    }
+
+#ifdef DEBUG_TEMP
+    timerComputeCost.Toc();
+    printf_s("Cost[%i] = %f\n", nPlanes, timerComputeCost.GetElapsedTime());
+#endif // DEBUG_TEMP
+
+#ifdef CL_VERSION_1_1
+    if (oclAcceleration) {
+        clReleaseMemObject(ocl.m_voxels);
+        for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+            clReleaseMemObject(ocl.m_partialVolumes[i]);
+        }
+        delete[] ocl.m_partialVolumes;
+    }
+#endif // CL_VERSION_1_1
+
+    if (params.m_logger) {
+        sprintf(msg, "\n\t\t\t Best  %04i T=%2.6f C=%2.6f B=%2.6f S=%2.6f (%1.1f, %1.1f, %1.1f, %3.3f)\n\n", iBest, minTotal, minConcavity, minBalance, minSymmetry, bestPlane.m_a, bestPlane.m_b, bestPlane.m_c, bestPlane.m_d);
+        params.m_logger->Log(msg);
+    }
+}
+void VHACD::ComputeClippingPlanesProxyCosts(const PrimitiveSet* inputPSet, const Array<Plane>& planes,
+    const Vec3<double>& preferredCuttingDirection, const double w, const double alpha, const double beta,
+    const int32_t convexhullDownsampling, const double progress0, const double progress1, SArray<double>& costs,
+    const Parameters& params)
+{
+    const int32_t nPlanes = static_cast<int32_t>(planes.Size());
+    costs.Resize(nPlanes);
+    m_nScreenedPlanes += nPlanes;
+    std::atomic<int32_t> done(0);
+    int32_t reported = 0;
+
+    PrimitiveSet* const onSurfacePSet = m_onSurfacePSet;
+    inputPSet->SelectOnSurface(onSurfacePSet);
+
 #if USE_THREAD == 1 && _OPENMP
 #pragma omp parallel for
 #endif
@@ -787,187 +1133,266 @@ void VHACD::ComputeBestClippingPlane(const PrimitiveSet* inputPSet, const double
         int32_t threadID = 0;
 #if USE_THREAD == 1 && _OPENMP
         threadID = omp_get_thread_num();
-#pragma omp flush(cancel)
-#endif
-        if (!cancel) {
-            //Update progress
-            if (GetCancel()) {
-                cancel = true;
-#if USE_THREAD == 1 && _OPENMP
-#pragma omp flush(cancel)
 #endif
-            }
-            Plane plane = planes[x];
+        if (!GetCancel()) {
+            const Plane& plane = planes[x];
+            PlaneEvaluationWorkspace& workspace = m_workspaces[threadID];
+            SArray<Vec3<double> >& leftCHPts = workspace.m_leftCHPts;
+            SArray<Vec3<double> >& rightCHPts = workspace.m_rightCHPts;
+            rightCHPts.Resize(0);
+            leftCHPts.Resize(0);
+            onSurfacePSet->Intersect(plane, &rightCHPts, &leftCHPts, convexhullDownsampling * CLIPPED_HULL_DOWNSAMPLING_SCALE);
+            inputPSet->GetConvexHull().Clip(plane, rightCHPts, leftCHPts);
+
+            // proxy convex-hull volumes: hulls of the k-DOP extreme points of each side
+            Mesh& ch = workspace.m_leftCH;
+            SArray<Vec3<double> >& extremePts = workspace.m_extremePts;
+            ComputeExtremePoints(leftCHPts, extremePts);
+            ch.ComputeConvexHull((double*)extremePts.Data(), extremePts.Size(), &workspace.m_hullComputer);
+            const double volumeLeftCH = ch.ComputeVolume();
+            ComputeExtremePoints(rightCHPts, extremePts);
+            ch.ComputeConvexHull((double*)extremePts.Data(), extremePts.Size(), &workspace.m_hullComputer);
+            const double volumeRightCH = ch.ComputeVolume();
 
-            if (oclAcceleration) {
-#ifdef CL_VERSION_1_1
-                const float fPlane[4] = { (float)plane.m_a, (float)plane.m_b, (float)plane.m_c, (float)plane.m_d };
-                cl_int error = clSetKernelArg(m_oclKernelComputePartialVolumes[threadID], 2, sizeof(float) * 4, fPlane);
-                if (error != CL_SUCCESS) {
-                    if (params.m_logger) {
-                        params.m_logger->Log("Couldn't kernel atguments \n");
-                    }
-                    SetCancel(true);
-                }
+            double volumeLeft = 0.0;
+            double volumeRight = 0.0;
+            inputPSet->ComputeClippedVolumes(plane, volumeRight, volumeLeft);
+            const double concavity = ComputeConcavity(volumeLeft, volumeLeftCH, m_volumeCH0) + ComputeConcavity(volumeRight, volumeRightCH, m_volumeCH0);
+            const double balance = alpha * fabs(volumeLeft - volumeRight) / m_volumeCH0;
+            const double d = w * (preferredCuttingDirection[0] * plane.m_a + preferredCuttingDirection[1] * plane.m_b + preferredCuttingDirection[2] * plane.m_c);
+            costs[x] = concavity + balance + beta * d;
+            UpdatePlaneProgress(done, reported, threadID, nPlanes, progress0, progress1, params);
+        }
+    }
+}
+// Minimum of the parabola through three samples of the cost curve (x0 < x1 < x2 and c1 <= c0, c1 <= c2)
+double PredictMinimumCost(const double x0, const double c0, const double x1, const double c1, const double x2, const double c2)
+{
+    const double p = (x1 - x0) * (c1 - c2);
+    const double q = (x1 - x2) * (c1 - c0);
+    const double den = p - q;
+    if (den == 0.0) {
+        return c1;
+    }
+    double x = x1 - 0.5 * ((x1 - x0) * p - (x1 - x2) * q) / den;
+    x = MIN(MAX(x, x0), x2);
+    const double c = c0 * (x - x1) * (x - x2) / ((x0 - x1) * (x0 - x2))
+        + c1 * (x - x0) * (x - x2) / ((x1 - x0) * (x1 - x2))
+        + c2 * (x - x0) * (x - x1) / ((x2 - x0) * (x2 - x1));
+    return MIN(c, c1);
+}
+void VHACD::ComputeBestClippingPlaneAdaptive(const PrimitiveSet* inputPSet, const double volume,
+    const Vec3<double>& preferredCuttingDirection, const double w, const double alpha, const double beta,
+    const double progress0, const double progress1, const double progress2, Plane& bestPlane,
+    double& minConcavity, const Parameters& params)
+{
+    if (GetCancel()) {
+        return;
+    }
+    const double unevaluated = -1.0;
+    const double queued = -2.0;
+    short range[3][2];
+    for (int32_t a = 0; a < 3; ++a) {
+        if (params.m_mode == 0) {
+            GetAxesAlignedClippingPlanesRange(*(const VoxelSet*)inputPSet, (AXIS)a, range[a][0], range[a][1]);
+        }
+        else {
+            GetAxesAlignedClippingPlanesRange(*(const TetrahedronSet*)inputPSet, (AXIS)a, range[a][0], range[a][1]);
+        }
+    }
 
-                error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputePartialVolumes[threadID],
-                    1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
-                if (error != CL_SUCCESS) {
-                    if (params.m_logger) {
-                        params.m_logger->Log("Couldn't run kernel \n");
-                    }
-                    SetCancel(true);
-                }
-                int32_t nValues = (int32_t)nWorkGroups;
-                while (nValues > 1) {
-                    error = clSetKernelArg(m_oclKernelComputeSum[threadID], 1, sizeof(int32_t), &nValues);
-                    if (error != CL_SUCCESS) {
-                        if (params.m_logger) {
-                            params.m_logger->Log("Couldn't kernel atguments \n");
-                        }
-                        SetCancel(true);
-                    }
-                    size_t nWorkGroups = (nValues + m_oclWorkGroupSize - 1) / m_oclWorkGroupSize;
-                    size_t globalSize = nWorkGroups * m_oclWorkGroupSize;
-                    error = clEnqueueNDRangeKernel(m_oclQueue[threadID], m_oclKernelComputeSum[threadID],
-                        1, NULL, &globalSize, &m_oclWorkGroupSize, 0, NULL, NULL);
-                    if (error != CL_SUCCESS) {
-                        if (params.m_logger) {
-                            params.m_logger->Log("Couldn't run kernel \n");
-                        }
-                        SetCancel(true);
-                    }
-                    nValues = (int32_t)nWorkGroups;
-                }
-#endif // CL_VERSION_1_1
+    // coarse sampling of the three cost curves, always including both ends of each axis
+    Array<Plane>& planes = m_searchPlanes;
+    planes.Resize(0);
+    Plane plane;
+    for (int32_t a = 0; a < 3; ++a) {
+        const int32_t i0 = range[a][0];
+        const int32_t i1 = range[a][1];
+        const int32_t step = MAX((i1 - i0) / PLANE_SEARCH_COARSE_SAMPLES + 1, (int32_t)params.m_planeDownsampling);
+        for (int32_t i = i0;; i += step) {
+            i = MIN(i, i1);
+            if (params.m_mode == 0) {
+                ComputeAxesAlignedClippingPlane(*(const VoxelSet*)inputPSet, (AXIS)a, (short)i, plane);
+            }
+            else {
+                ComputeAxesAlignedClippingPlane(*(const TetrahedronSet*)inputPSet, (AXIS)a, (short)i, plane);
             }
+            planes.PushBack(plane);
+            if (i == i1) {
+                break;
+            }
+        }
+    }
+    const size_t nCoarsePlanes = planes.Size();
+    SArray<double>& costs = m_searchCosts;
+    double batchConcavity = MAX_DOUBLE;
+    // with plane screening, the coarse cost curves are sampled with the proxy and the exact convex-hulls
+    // are left to the refinement, which stops once maxExactPlanes planes have been evaluated
+    const size_t maxExactPlanes = params.m_maxExactClippingPlanes;
+    if (maxExactPlanes > 0) {
+        ComputeClippingPlanesProxyCosts(inputPSet, planes, preferredCuttingDirection, w, alpha, beta,
+            params.m_convexhullDownsampling, progress0, progress1, costs, params);
+    }
+    else {
+        ComputeBestClippingPlane(inputPSet, volume, planes, preferredCuttingDirection, w, alpha, beta,
+            params.m_convexhullDownsampling, progress0, progress1, bestPlane, batchConcavity, params, &costs);
+    }
+    if (GetCancel()) {
+        return;
+    }
+    const bool exactCoarseCosts = params.m_convexhullDownsampling == 1 && maxExactPlanes == 0;
 
-            Mesh& leftCH = chs[threadID];
-            Mesh& rightCH = chs[threadID + m_ompNumProcessors];
-            rightCH.ResizePoints(0);
-            leftCH.ResizePoints(0);
-            rightCH.ResizeTriangles(0);
-            leftCH.ResizeTriangles(0);
+    // exact costs of the refined planes, indexed per axis by the plane index
+    SArray<double>* const exactCosts = m_searchExactCosts;
+    for (int32_t a = 0; a < 3; ++a) {
+        const size_t n = range[a][1] - range[a][0] + 1;
+        exactCosts[a].Resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            exactCosts[a][i] = unevaluated;
+        }
+    }
+    double minTotal = MAX_DOUBLE;
+    minConcavity = batchConcavity;
+    for (size_t p = 0; p < nCoarsePlanes; ++p) {
+        minTotal = MIN(minTotal, costs[p]);
+        if (exactCoarseCosts) {
+            // the coarse pass already used exact convex-hulls at full sampling
+            exactCosts[planes[p].m_axis][planes[p].m_index - range[planes[p].m_axis][0]] = costs[p];
+        }
+    }
 
-// compute convex-hulls
-#ifdef TEST_APPROX_CH
-            double volumeLeftCH1;
-            double volumeRightCH1;
-#endif //TEST_APPROX_CH
-            if (params.m_convexhullApproximation) {
-                SArray<Vec3<double> >& leftCHPts = chPts[threadID];
-                SArray<Vec3<double> >& rightCHPts = chPts[threadID + m_ompNumProcessors];
-                rightCHPts.Resize(0);
-                leftCHPts.Resize(0);
-                onSurfacePSet->Intersect(plane, &rightCHPts, &leftCHPts, convexhullDownsampling * 32);
-                inputPSet->GetConvexHull().Clip(plane, rightCHPts, leftCHPts);
-                rightCH.ComputeConvexHull((double*)rightCHPts.Data(), rightCHPts.Size());
-                leftCH.ComputeConvexHull((double*)leftCHPts.Data(), leftCHPts.Size());
-#ifdef TEST_APPROX_CH
-                Mesh leftCH1;
-                Mesh rightCH1;
-                VoxelSet right;
-                VoxelSet left;
-                onSurfacePSet->Clip(plane, &right, &left);
-                right.ComputeConvexHull(rightCH1, convexhullDownsampling);
-                left.ComputeConvexHull(leftCH1, convexhullDownsampling);
-
-                volumeLeftCH1 = leftCH1.ComputeVolume();
-                volumeRightCH1 = rightCH1.ComputeVolume();
-#endif //TEST_APPROX_CH
+    // fit the coarse cost curve of each axis and keep the local minima predicted to beat the best coarse plane
+    SArray<PlaneSearchBracket>& brackets = m_searchBrackets;
+    brackets.Resize(0);
+    for (size_t p0 = 0; p0 < nCoarsePlanes;) {
+        size_t p1 = p0;
+        while (p1 < nCoarsePlanes && planes[p1].m_axis == planes[p0].m_axis) {
+            ++p1;
+        }
+        for (size_t p = p0; p < p1; ++p) {
+            const bool hasPrev = p > p0;
+            const bool hasNext = p + 1 < p1;
+            if ((hasPrev && costs[p] >= costs[p - 1]) || (hasNext && costs[p] > costs[p + 1])) {
+                continue;
             }
-            else {
-                PrimitiveSet* const right = psets[threadID];
-                PrimitiveSet* const left = psets[threadID + m_ompNumProcessors];
-                onSurfacePSet->Clip(plane, right, left);
-                right->ComputeConvexHull(rightCH, convexhullDownsampling);
-                left->ComputeConvexHull(leftCH, convexhullDownsampling);
+            PlaneSearchBracket bracket;
+            bracket.m_axis = planes[p].m_axis;
+            bracket.m_lo = hasPrev ? planes[p - 1].m_index : planes[p].m_index;
+            bracket.m_hi = hasNext ? planes[p + 1].m_index : planes[p].m_index;
+            bracket.m_predictedCost = costs[p];
+            if (hasPrev && hasNext) {
+                bracket.m_predictedCost = PredictMinimumCost(planes[p - 1].m_index, costs[p - 1],
+                    planes[p].m_index, costs[p], planes[p + 1].m_index, costs[p + 1]);
             }
-            double volumeLeftCH = leftCH.ComputeVolume();
-            double volumeRightCH = rightCH.ComputeVolume();
-
-            // compute clipped volumes
-            double volumeLeft = 0.0;
-            double volumeRight = 0.0;
-            if (oclAcceleration) {
-#ifdef CL_VERSION_1_1
-                uint32_t volumes[4];
-                cl_int error = clEnqueueReadBuffer(m_oclQueue[threadID], partialVolumes[threadID], CL_TRUE,
-                    0, sizeof(uint32_t) * 4, volumes, 0, NULL, NULL);
-                size_t nPrimitivesRight = volumes[0] + volumes[1] + volumes[2] + volumes[3];
-                size_t nPrimitivesLeft = nPrimitives - nPrimitivesRight;
-                volumeRight = nPrimitivesRight * unitVolume;
-                volumeLeft = nPrimitivesLeft * unitVolume;
-                if (error != CL_SUCCESS) {
-                    if (params.m_logger) {
-                        params.m_logger->Log("Couldn't read buffer \n");
-                    }
-                    SetCancel(true);
+            bracket.m_active = true;
+            if (bracket.m_predictedCost <= minTotal) {
+                brackets.PushBack(bracket);
+            }
+        }
+        p0 = p1;
+    }
+    std::stable_sort(brackets.Data(), brackets.Data() + brackets.Size());
+    brackets.Resize(MIN(brackets.Size(), (size_t)PLANE_SEARCH_MAX_BRACKETS));
+
+    // golden-section search of all the brackets in lockstep, so that the probes of one round
+    // are evaluated by a single parallel pass at full convex-hull sampling
+    const double invPhi2 = 0.381966011250105;
+    size_t nRefinedPlanes = 0;
+    if (!exactCoarseCosts) {
+        // the coarse costs are only estimates, the best plane has to come from the refinement
+        minTotal = MAX_DOUBLE;
+    }
+    bool refine = true;
+    bool budgetExhausted = false;
+    while (refine && !GetCancel()) {
+        refine = false;
+        planes.Resize(0);
+        for (size_t b = 0; b < brackets.Size(); ++b) {
+            PlaneSearchBracket& bracket = brackets[b];
+            if (!bracket.m_active) {
+                continue;
+            }
+            int32_t probes[4];
+            int32_t nProbes = 0;
+            if (bracket.m_hi - bracket.m_lo <= 3) {
+                for (int32_t i = bracket.m_lo; i <= bracket.m_hi; ++i) {
+                    probes[nProbes++] = i;
                 }
-#endif // CL_VERSION_1_1
             }
             else {
-                inputPSet->ComputeClippedVolumes(plane, volumeRight, volumeLeft);
+                const int32_t offset = (int32_t)((bracket.m_hi - bracket.m_lo) * invPhi2 + 0.5);
+                probes[nProbes++] = bracket.m_lo + offset;
+                probes[nProbes++] = MAX(bracket.m_hi - offset, bracket.m_lo + offset + 1);
             }
-            double concavityLeft = ComputeConcavity(volumeLeft, volumeLeftCH, m_volumeCH0);
-            double concavityRight = ComputeConcavity(volumeRight, volumeRightCH, m_volumeCH0);
-            double concavity = (concavityLeft + concavityRight);
-
-            // compute cost
-            double balance = alpha * fabs(volumeLeft - volumeRight) / m_volumeCH0;
-            double d = w * (preferredCuttingDirection[0] * plane.m_a + preferredCuttingDirection[1] * plane.m_b + preferredCuttingDirection[2] * plane.m_c);
-            double symmetry = beta * d;
-            double total = concavity + balance + symmetry;
-
-#if USE_THREAD == 1 && _OPENMP
-#pragma omp critical
-#endif
-            {
-                if (total < minTotal || (total == minTotal && x < iBest)) {
-                    minConcavity = concavity;
-                    minBalance = balance;
-                    minSymmetry = symmetry;
-                    bestPlane = plane;
-                    minTotal = total;
-                    iBest = x;
-                }
-                ++done;
-                if (!(done & 127)) // reduce update frequency
-                {
-                    double progress = done * (progress1 - progress0) / nPlanes + progress0;
-                    Update(m_stageProgress, progress, params);
+            SArray<double>& axisCosts = exactCosts[bracket.m_axis];
+            const int32_t i0 = range[bracket.m_axis][0];
+            for (int32_t k = 0; k < nProbes; ++k) {
+                if (axisCosts[probes[k] - i0] == unevaluated) {
+                    axisCosts[probes[k] - i0] = queued;
+                    if (params.m_mode == 0) {
+                        ComputeAxesAlignedClippingPlane(*(const VoxelSet*)inputPSet, bracket.m_axis, (short)probes[k], plane);
+                    }
+                    else {
+                        ComputeAxesAlignedClippingPlane(*(const TetrahedronSet*)inputPSet, bracket.m_axis, (short)probes[k], plane);
+                    }
+                    planes.PushBack(plane);
                 }
             }
         }
-    }
-
-#ifdef DEBUG_TEMP
-    timerComputeCost.Toc();
-    printf_s("Cost[%i] = %f\n", nPlanes, timerComputeCost.GetElapsedTime());
-#endif // DEBUG_TEMP
-
-#ifdef CL_VERSION_1_1
-    if (oclAcceleration) {
-        clReleaseMemObject(voxels);
-        for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
-            clReleaseMemObject(partialVolumes[i]);
+        if (maxExactPlanes > 0 && nRefinedPlanes + planes.Size() >= maxExactPlanes) {
+            // the brackets are sorted by predicted cost, so the probes of the most promising ones are kept
+            planes.Resize(maxExactPlanes - nRefinedPlanes);
+            budgetExhausted = true;
         }
-        delete[] partialVolumes;
-    }
-#endif // CL_VERSION_1_1
-
-    if (psets) {
-        for (int32_t i = 0; i < 2 * m_ompNumProcessors; ++i) {
-            delete psets[i];
+        const size_t nPlanes = planes.Size();
+        if (nPlanes > 0) {
+            Plane batchBestPlane;
+            ComputeBestClippingPlane(inputPSet, volume, planes, preferredCuttingDirection, w, alpha, beta,
+                1, // convexhullDownsampling = 1
+                progress1, progress2, batchBestPlane, batchConcavity, params, &costs);
+            if (GetCancel()) {
+                return;
+            }
+            nRefinedPlanes += nPlanes;
+            double batchMinTotal = MAX_DOUBLE;
+            for (size_t p = 0; p < nPlanes; ++p) {
+                exactCosts[planes[p].m_axis][planes[p].m_index - range[planes[p].m_axis][0]] = costs[p];
+                batchMinTotal = MIN(batchMinTotal, costs[p]);
+            }
+            if (batchMinTotal < minTotal) {
+                minTotal = batchMinTotal;
+                minConcavity = batchConcavity;
+                bestPlane = batchBestPlane;
+            }
+        }
+        for (size_t b = 0; b < brackets.Size() && !budgetExhausted; ++b) {
+            PlaneSearchBracket& bracket = brackets[b];
+            if (!bracket.m_active) {
+                continue;
+            }
+            if (bracket.m_hi - bracket.m_lo <= 3) {
+                bracket.m_active = false;
+                continue;
+            }
+            const int32_t offset = (int32_t)((bracket.m_hi - bracket.m_lo) * invPhi2 + 0.5);
+            const int32_t x1 = bracket.m_lo + offset;
+            const int32_t x2 = MAX(bracket.m_hi - offset, x1 + 1);
+            const SArray<double>& axisCosts = exactCosts[bracket.m_axis];
+            const int32_t i0 = range[bracket.m_axis][0];
+            if (axisCosts[x1 - i0] <= axisCosts[x2 - i0]) {
+                bracket.m_hi = x2;
+            }
+            else {
+                bracket.m_lo = x1;
+            }
+            refine = true;
         }
-        delete[] psets;
     }
-    delete onSurfacePSet;
-    delete[] chPts;
-    delete[] chs;
     if (params.m_logger) {
-        sprintf(msg, "\n\t\t\t Best  %04i T=%2.6f C=%2.6f B=%2.6f S=%2.6f (%1.1f, %1.1f, %1.1f, %3.3f)\n\n", iBest, minTotal, minConcavity, minBalance, minSymmetry, bestPlane.m_a, bestPlane.m_b, bestPlane.m_c, bestPlane.m_d);
-        params.m_logger->Log(msg);
+        std::ostringstream msg;
+        msg << "\t\t [Adaptive search] Number of clipping planes " << nCoarsePlanes << (maxExactPlanes > 0 ? " coarse (proxy) + " : " coarse + ")
+            << nRefinedPlanes << " refined (" << brackets.Size() << " intervals)" << std::endl;
+        params.m_logger->Log(msg.str().c_str());
     }
 }
 void VHACD::ComputeACD(const Parameters& params)
@@ -985,13 +1410,15 @@ void VHACD::ComputeACD(const Parameters& params)
         params.m_logger->Log(msg.str().c_str());
     }
 
-    SArray<PrimitiveSet*> parts;
-    SArray<PrimitiveSet*> inputParts;
-    SArray<PrimitiveSet*> temp;
+    PreparePlaneEvaluationWorkspaces(params);
+
+    Array<PrimitiveSet*> parts(&m_arenas[0]);
+    Array<PrimitiveSet*> inputParts(&m_arenas[0]);
+    Array<PrimitiveSet*> temp(&m_arenas[0]);
     inputParts.PushBack(m_pset);
     m_pset = 0;
-    SArray<Plane> planes;
-    SArray<Plane> planesRef;
+    Array<Plane> planes(&m_arenas[0]);
+    Array<Plane> planesRef(&m_arenas[0]);
     uint32_t sub = 0;
     bool firstIteration = true;
     m_volumeCH0 = 1.0;
@@ -1019,7 +1446,7 @@ void VHACD::ComputeACD(const Parameters& params)
 	depth++;
 
 
-    while (sub++ < depth && inputParts.Size() > 0 && !m_cancel) {
+    while (sub++ < depth && inputParts.Size() > 0 && !GetCancel()) {
         msg.str("");
         msg << "Subdivision level " << sub;
         m_operation = msg.str();
@@ -1033,7 +1460,7 @@ void VHACD::ComputeACD(const Parameters& params)
         double maxConcavity = 0.0;
         const size_t nInputParts = inputParts.Size();
         Update(m_stageProgress, 0.0, params);
-        for (size_t p = 0; p < nInputParts && !m_cancel; ++p) {
+        for (size_t p = 0; p < nInputParts && !GetCancel(); ++p) {
             const double progress0 = p * 100.0 / nInputParts;
             const double progress1 = (p + 0.75) * 100.0 / nInputParts;
             const double progress2 = (p + 1.00) * 100.0 / nInputParts;
@@ -1049,7 +1476,7 @@ void VHACD::ComputeACD(const Parameters& params)
                 pset->AlignToPrincipalAxes();
             }
 
-            pset->ComputeConvexHull(pset->GetConvexHull());
+            pset->ComputeConvexHull(pset->GetConvexHull(), 1, &m_workspaces[0].m_hullComputer);
             double volumeCH = fabs(pset->GetConvexHull().ComputeVolume());
             if (firstIteration) {
                 m_volumeCH0 = volumeCH;
@@ -1076,67 +1503,94 @@ void VHACD::ComputeACD(const Parameters& params)
             if (concavity > params.m_concavity && concavity > error) {
                 Vec3<double> preferredCuttingDirection;
                 double w = ComputePreferredCuttingDirection(pset, preferredCuttingDirection);
-                planes.Resize(0);
-                if (params.m_mode == 0) {
-                    VoxelSet* vset = (VoxelSet*)pset;
-                    ComputeAxesAlignedClippingPlanes(*vset, params.m_planeDownsampling, planes);
-                }
-                else {
-                    TetrahedronSet* tset = (TetrahedronSet*)pset;
-                    ComputeAxesAlignedClippingPlanes(*tset, params.m_planeDownsampling, planes);
-                }
-
-                if (params.m_logger) {
-                    msg.str("");
-                    msg << "\t\t [Regular sampling] Number of clipping planes " << planes.Size() << std::endl;
-                    params.m_logger->Log(msg.str().c_str());
-                }
-
                 Plane bestPlane;
                 double minConcavity = MAX_DOUBLE;
-                ComputeBestClippingPlane(pset,
-                    volume,
-                    planes,
-                    preferredCuttingDirection,
-                    w,
-                    concavity * params.m_alpha,
-                    concavity * params.m_beta,
-                    params.m_convexhullDownsampling,
-                    progress0,
-                    progress1,
-                    bestPlane,
-                    minConcavity,
-                    params);
-                if (!m_cancel && (params.m_planeDownsampling > 1 || params.m_convexhullDownsampling > 1)) {
-                    planesRef.Resize(0);
-
+                const size_t nEvaluatedPlanes = m_nEvaluatedPlanes;
+                const size_t nScreenedPlanes = m_nScreenedPlanes;
+                if (params.m_adaptivePlaneSearch) {
+                    ComputeBestClippingPlaneAdaptive(pset,
+                        volume,
+                        preferredCuttingDirection,
+                        w,
+                        concavity * params.m_alpha,
+                        concavity * params.m_beta,
+                        progress0,
+                        progress1,
+                        progress2,
+                        bestPlane,
+                        minConcavity,
+                        params);
+                }
+                else {
+                    planes.Resize(0);
                     if (params.m_mode == 0) {
                         VoxelSet* vset = (VoxelSet*)pset;
-                        RefineAxesAlignedClippingPlanes(*vset, bestPlane, params.m_planeDownsampling, planesRef);
+                        ComputeAxesAlignedClippingPlanes(*vset, params.m_planeDownsampling, planes);
                     }
                     else {
                         TetrahedronSet* tset = (TetrahedronSet*)pset;
-                        RefineAxesAlignedClippingPlanes(*tset, bestPlane, params.m_planeDownsampling, planesRef);
+                        ComputeAxesAlignedClippingPlanes(*tset, params.m_planeDownsampling, planes);
                     }
 
                     if (params.m_logger) {
                         msg.str("");
-                        msg << "\t\t [Refining] Number of clipping planes " << planesRef.Size() << std::endl;
+                        msg << "\t\t [Regular sampling] Number of clipping planes " << planes.Size() << std::endl;
                         params.m_logger->Log(msg.str().c_str());
                     }
+
                     ComputeBestClippingPlane(pset,
                         volume,
-                        planesRef,
+                        planes,
                         preferredCuttingDirection,
                         w,
                         concavity * params.m_alpha,
                         concavity * params.m_beta,
-                        1, // convexhullDownsampling = 1
+                        params.m_convexhullDownsampling,
+                        progress0,
                         progress1,
-                        progress2,
                         bestPlane,
                         minConcavity,
                         params);
+                    if (!GetCancel() && (params.m_planeDownsampling > 1 || params.m_convexhullDownsampling > 1)) {
+                        planesRef.Resize(0);
+
+                        if (params.m_mode == 0) {
+                            VoxelSet* vset = (VoxelSet*)pset;
+                            RefineAxesAlignedClippingPlanes(*vset, bestPlane, params.m_planeDownsampling, planesRef);
+                        }
+                        else {
+                            TetrahedronSet* tset = (TetrahedronSet*)pset;
+                            RefineAxesAlignedClippingPlanes(*tset, bestPlane, params.m_planeDownsampling, planesRef);
+                        }
+
+                        if (params.m_logger) {
+                            msg.str("");
+                            msg << "\t\t [Refining] Number of clipping planes " << planesRef.Size() << std::endl;
+                            params.m_logger->Log(msg.str().c_str());
+                        }
+                        ComputeBestClippingPlane(pset,
+                            volume,
+                            planesRef,
+                            preferredCuttingDirection,
+                            w,
+                            concavity * params.m_alpha,
+                            concavity * params.m_beta,
+                            1, // convexhullDownsampling = 1
+                            progress1,
+                            progress2,
+                            bestPlane,
+                            minConcavity,
+                            params);
+                    }
+                }
+                if (params.m_logger) {
+                    msg.str("");
+                    msg << "\t\t [Clipping planes] " << m_nEvaluatedPlanes - nEvaluatedPlanes << " evaluated";
+                    if (m_nScreenedPlanes > nScreenedPlanes) {
+                        msg << ", " << m_nScreenedPlanes - nScreenedPlanes << " screened";
+                    }
+                    msg << std::endl;
+                    params.m_logger->Log(msg.str().c_str());
                 }
                 if (GetCancel()) {
                     delete pset; // clean up
@@ -1175,7 +1629,8 @@ void VHACD::ComputeACD(const Parameters& params)
             temp.Resize(0);
         }
         else {
-            inputParts = temp;
+            // the next level's parts take the buffer of this level's, whose pointers were all handed over
+            inputParts.Swap(temp);
             temp.Resize(0);
         }
     }
@@ -1192,6 +1647,20 @@ void VHACD::ComputeACD(const Parameters& params)
         return;
     }
 
+    if (params.m_logger) {
+        msg.str("");
+        msg << "\t # clipping planes evaluated  " << m_nEvaluatedPlanes << std::endl;
+        if (m_nScreenedPlanes) {
+            msg << "\t # clipping planes screened   " << m_nScreenedPlanes;
+            if (m_maxBestPlaneProxyRank >= 0) {
+                // only the exhaustive search ranks its candidates, the adaptive one refines the proxy minima
+                msg << " (max. proxy rank of best plane " << m_maxBestPlaneProxyRank << ")";
+            }
+            msg << std::endl;
+        }
+        params.m_logger->Log(msg.str().c_str());
+    }
+
     m_overallProgress = 90.0;
     Update(m_stageProgress, 100.0, params);
 
@@ -1207,14 +1676,14 @@ void VHACD::ComputeACD(const Parameters& params)
 
     Update(m_stageProgress, 0.0, params);
     m_convexHulls.Resize(0);
-    for (size_t p = 0; p < nConvexHulls && !m_cancel; ++p) {
+    for (size_t p = 0; p < nConvexHulls && !GetCancel(); ++p) {
         Update(m_stageProgress, p * 100.0 / nConvexHulls, params);
-        m_convexHulls.PushBack(new Mesh);
-        parts[p]->ComputeConvexHull(*m_convexHulls[p]);
-        size_t nv = m_convexHulls[p]->GetNPoints();
+        Mesh ch;
+        parts[p]->ComputeConvexHull(ch, 1, &m_workspaces[0].m_hullComputer);
+        size_t nv = ch.GetNPoints();
         double x, y, z;
         for (size_t i = 0; i < nv; ++i) {
-            Vec3<double>& pt = m_convexHulls[p]->GetPoint(i);
+            Vec3<double>& pt = ch.GetPoint(i);
             x = pt[0];
             y = pt[1];
             z = pt[2];
@@ -1222,6 +1691,7 @@ void VHACD::ComputeACD(const Parameters& params)
             pt[1] = m_rot[1][0] * x + m_rot[1][1] * y + m_rot[1][2] * z + m_barycenter[1];
             pt[2] = m_rot[2][0] * x + m_rot[2][1] * y + m_rot[2][2] * z + m_barycenter[2];
         }
+        m_convexHulls.PushBack(new ConvexHullMesh(std::move(ch)));
     }
 
     const size_t nParts = parts.Size();
@@ -1245,44 +1715,186 @@ void VHACD::ComputeACD(const Parameters& params)
     m_timer.Toc();
     if (params.m_logger) {
         msg.str("");
+        if (params.m_filterHullPoints) {
+            uint64_t nInputPoints = 0;
+            uint64_t nRejectedPoints = 0;
+            for (int32_t i = 0; i < m_ompNumProcessors; ++i) {
+                const HullPointFilter& filter = m_workspaces[i].m_hullComputer.getPointFilter();
+                nInputPoints += filter.GetNInputPoints();
+                nRejectedPoints += filter.GetNRejectedPoints();
+            }
+            msg << "\t\t [Hull prefilter] " << nRejectedPoints << " of " << nInputPoints << " points discarded ("
+                << ((nInputPoints) ? (100.0 * nRejectedPoints) / nInputPoints : 0.0) << "%)" << std::endl;
+        }
         msg << "\t time " << m_timer.GetElapsedTime() / 1000.0 << "s" << std::endl;
         params.m_logger->Log(msg.str().c_str());
     }
 }
-void AddPoints(const Mesh* const mesh, SArray<Vec3<double> >& pts)
+void AddPoints(const ConvexHullMesh* const hull, SArray<Vec3<double> >& pts)
 {
-    const int32_t n = (int32_t)mesh->GetNPoints();
+    const int32_t n = (int32_t)hull->GetNPoints();
     for (int32_t i = 0; i < n; ++i) {
-        pts.PushBack(mesh->GetPoint(i));
+        pts.PushBack(hull->GetPoint(i));
     }
 }
-void ComputeConvexHull(const Mesh* const ch1, const Mesh* const ch2, SArray<Vec3<double> >& pts, Mesh* const combinedCH)
+// Vertices spanning the convex-hull of the union of two convex-hulls. A general hull computation is still needed on
+// them: btConvexHullInternal::merge only joins hulls separated along its sorting axis, which merge candidates are not.
+void AddUnionPoints(const ConvexHullMesh* const ch1, const ConvexHullMesh* const ch2, SArray<Vec3<double> >& pts)
 {
     pts.Resize(0);
-    AddPoints(ch1, pts);
-    AddPoints(ch2, pts);
-
-    btConvexHullComputer ch;
-    ch.compute((double*)pts.Data(), 3 * sizeof(double), (int32_t)pts.Size(), -1.0, -1.0);
-    combinedCH->ResizePoints(0);
-    combinedCH->ResizeTriangles(0);
-    for (int32_t v = 0; v < ch.vertices.size(); v++) {
-        combinedCH->AddPoint(Vec3<double>(ch.vertices[v].getX(), ch.vertices[v].getY(), ch.vertices[v].getZ()));
-    }
-    const int32_t nt = ch.faces.size();
+    ch1->AddPointsOutside(*ch2, pts);
+    ch2->AddPointsOutside(*ch1, pts);
+}
+void ComputeConvexHull(const ConvexHullMesh* const ch1, const ConvexHullMesh* const ch2, SArray<Vec3<double> >& pts,
+    Mesh* const combinedCH, btConvexHullComputer* const hullComputer = 0)
+{
+    AddUnionPoints(ch1, ch2, pts);
+    combinedCH->ComputeConvexHull((double*)pts.Data(), pts.Size(), hullComputer);
+}
+// Volume of the convex-hull of the union, computed from the faces of the hull computer without building the triangle
+// mesh (same summation as Mesh::ComputeVolume)
+double ComputeConvexHullVolume(const ConvexHullMesh* const ch1, const ConvexHullMesh* const ch2,
+    SArray<Vec3<double> >& pts, btConvexHullComputer& hullComputer)
+{
+    AddUnionPoints(ch1, ch2, pts);
+    hullComputer.compute((double*)pts.Data(), 3 * sizeof(double), (int32_t)pts.Size(), -1.0, -1.0);
+    const int32_t nv = hullComputer.vertices.size();
+    const int32_t nt = hullComputer.faces.size();
+    if (nv == 0 || nt == 0) {
+        return 0.0;
+    }
+    pts.Resize(nv);
+    Vec3<double> bary(0.0, 0.0, 0.0);
+    for (int32_t v = 0; v < nv; ++v) {
+        pts[v] = Vec3<double>(hullComputer.vertices[v].getX(), hullComputer.vertices[v].getY(), hullComputer.vertices[v].getZ());
+        bary += pts[v];
+    }
+    bary /= static_cast<double>(nv);
+    double totalVolume = 0.0;
     for (int32_t t = 0; t < nt; ++t) {
-        const btConvexHullComputer::Edge* sourceEdge = &(ch.edges[ch.faces[t]]);
-        int32_t a = sourceEdge->getSourceVertex();
+        const btConvexHullComputer::Edge* sourceEdge = &(hullComputer.edges[hullComputer.faces[t]]);
+        const int32_t a = sourceEdge->getSourceVertex();
         int32_t b = sourceEdge->getTargetVertex();
         const btConvexHullComputer::Edge* edge = sourceEdge->getNextEdgeOfFace();
         int32_t c = edge->getTargetVertex();
         while (c != a) {
-            combinedCH->AddTriangle(Vec3<int32_t>(a, b, c));
+            totalVolume += ComputeVolume4(pts[a], pts[b], pts[c], bary);
             edge = edge->getNextEdgeOfFace();
             b = c;
             c = edge->getTargetVertex();
         }
     }
+    return totalVolume / 6.0;
+}
+inline bool OverlapAABB(const ConvexHullMesh* const ch1, const ConvexHullMesh* const ch2, const double tolerance)
+{
+    const Vec3<double>& minBB1 = ch1->GetMinBB();
+    const Vec3<double>& maxBB1 = ch1->GetMaxBB();
+    const Vec3<double>& minBB2 = ch2->GetMinBB();
+    const Vec3<double>& maxBB2 = ch2->GetMaxBB();
+    return minBB1[0] <= maxBB2[0] + tolerance && minBB2[0] <= maxBB1[0] + tolerance
+        && minBB1[1] <= maxBB2[1] + tolerance && minBB2[1] <= maxBB1[1] + tolerance
+        && minBB1[2] <= maxBB2[2] + tolerance && minBB2[2] <= maxBB1[2] + tolerance;
+}
+typedef std::priority_queue<HullMergeCandidate, std::vector<HullMergeCandidate>, std::greater<HullMergeCandidate> > HullMergeQueue;
+inline double AABBVolume(const Vec3<double>& minBB, const Vec3<double>& maxBB)
+{
+    return std::max(0.0, maxBB[0] - minBB[0]) * std::max(0.0, maxBB[1] - minBB[1]) * std::max(0.0, maxBB[2] - minBB[2]);
+}
+double VHACD::ComputeMergeCost(const HullMergeCandidate& candidate, const std::vector<const ConvexHullMesh*>& hulls,
+    PlaneEvaluationWorkspace& workspace)
+{
+    // As in the former cost matrix, the volume of the newest hull of the pair (the higher one for two leaves) is
+    // rounded to float: nested hulls then tie at a zero cost the same way
+    const bool newest1 = candidate.m_version1 > candidate.m_version2;
+    const ConvexHullMesh* const ch1 = hulls[newest1 ? candidate.m_p1 : candidate.m_p2];
+    const ConvexHullMesh* const ch2 = hulls[newest1 ? candidate.m_p2 : candidate.m_p1];
+    const double volumeCH = ComputeConvexHullVolume(ch1, ch2, workspace.m_leftCHPts, workspace.m_hullComputer);
+    return ComputeConcavity((float)ch1->GetVolume() + ch2->GetVolume(), volumeCH, m_volumeCH0);
+}
+double VHACD::ComputeMergeCostBound(const int32_t p1, const int32_t p2, const std::vector<const ConvexHullMesh*>& hulls,
+    const std::vector<Vec3<double> >& extremePts, const std::vector<int32_t>& nExtremePts,
+    PlaneEvaluationWorkspace& workspace)
+{
+    // The volume of the hull of the union lies in [volumeMin, volumeMax]:
+    // - it contains each hull, and the union of the two hulls (whose overlap is at most the overlap of their boxes),
+    // - it contains the hull of the k-DOP extreme points of both hulls,
+    // - it is contained in the bounding box of both hulls.
+    const ConvexHullMesh* const ch1 = hulls[p1];
+    const ConvexHullMesh* const ch2 = hulls[p2];
+    const double volume = ch1->GetVolume() + ch2->GetVolume();
+    Vec3<double> minBBI, maxBBI, minBBU, maxBBU;
+    for (int32_t h = 0; h < 3; ++h) {
+        minBBI[h] = std::max(ch1->GetMinBB()[h], ch2->GetMinBB()[h]);
+        maxBBI[h] = std::min(ch1->GetMaxBB()[h], ch2->GetMaxBB()[h]);
+        minBBU[h] = std::min(ch1->GetMinBB()[h], ch2->GetMinBB()[h]);
+        maxBBU[h] = std::max(ch1->GetMaxBB()[h], ch2->GetMaxBB()[h]);
+    }
+    double volumeMin = std::max(std::max(ch1->GetVolume(), ch2->GetVolume()), volume - AABBVolume(minBBI, maxBBI));
+    const double volumeMax = AABBVolume(minBBU, maxBBU);
+    if (volumeMin <= volume && volume <= volumeMax) {
+        SArray<Vec3<double> >& pts = workspace.m_extremePts;
+        pts.Resize(0);
+        for (int32_t i = 0; i < nExtremePts[p1]; ++i) {
+            pts.PushBack(extremePts[p1 * g_nKDOPExtremePoints + i]);
+        }
+        for (int32_t i = 0; i < nExtremePts[p2]; ++i) {
+            pts.PushBack(extremePts[p2 * g_nKDOPExtremePoints + i]);
+        }
+        workspace.m_leftCH.ComputeConvexHull((double*)pts.Data(), pts.Size(), &workspace.m_hullComputer);
+        // shrunk to stay below the exact volume despite the round-off errors
+        volumeMin = std::max(volumeMin, workspace.m_leftCH.ComputeVolume() * (1.0 - MERGE_BOUND_TOLERANCE));
+    }
+    if (volume < volumeMin) {
+        return ComputeConcavity(volume, volumeMin, m_volumeCH0);
+    }
+    if (volume > volumeMax) {
+        return ComputeConcavity(volume, volumeMax, m_volumeCH0);
+    }
+    return 0.0;
+}
+void VHACD::ComputeMergeCosts(std::vector<HullMergeCandidate>& candidates, const std::vector<const ConvexHullMesh*>& hulls,
+    const std::vector<Vec3<double> >& extremePts, const std::vector<int32_t>& nExtremePts, const bool lazy)
+{
+    // each candidate is computed independently, in its own slot, with the scratch memory of the thread
+    const int32_t nCandidates = static_cast<int32_t>(candidates.size());
+#if USE_THREAD == 1 && _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (int32_t c = 0; c < nCandidates; ++c) {
+        int32_t threadID = 0;
+#if USE_THREAD == 1 && _OPENMP
+        threadID = omp_get_thread_num();
+#endif
+        if (!GetCancel()) {
+            HullMergeCandidate& candidate = candidates[c];
+            PlaneEvaluationWorkspace& workspace = m_workspaces[threadID];
+            if (lazy) {
+                candidate.m_cost = (float)ComputeMergeCostBound(candidate.m_p1, candidate.m_p2, hulls, extremePts, nExtremePts,
+                    workspace);
+            }
+            else {
+                candidate.m_cost = (float)ComputeMergeCost(candidate, hulls, workspace);
+            }
+            candidate.m_exact = !lazy;
+        }
+    }
+}
+// Applies a merge to the leaf hull slots. The positions of the remaining hulls follow the order of the former cost
+// matrix merge: the merged hull takes the lower position of the pair and the last hull moves to the higher one
+inline void ApplyHullMerge(const HullMergeRecord& record, std::vector<const ConvexHullMesh*>& hulls,
+    std::vector<int32_t>& positions, std::vector<int32_t>& slots)
+{
+    const int32_t lo = std::min(positions[record.m_p1], positions[record.m_p2]);
+    const int32_t hi = std::max(positions[record.m_p1], positions[record.m_p2]);
+    hulls[record.m_p1] = record.m_hull;
+    hulls[record.m_p2] = 0;
+    slots[hi] = slots.back();
+    positions[slots[hi]] = hi;
+    slots.pop_back();
+    slots[lo] = record.m_p1;
+    positions[record.m_p1] = lo;
+    positions[record.m_p2] = -1;
 }
 void VHACD::MergeConvexHulls(const Parameters& params)
 {
@@ -1299,116 +1911,247 @@ void VHACD::MergeConvexHulls(const Parameters& params)
         params.m_logger->Log(msg.str().c_str());
     }
 
-	// Get the current number of convex hulls
-    size_t nConvexHulls = m_convexHulls.Size();
+    // The merge starts from the leaf hulls of the decomposition: the merges recorded by the previous calls are
+    // replayed, and the greedy merge only runs past the end of the history (extending it)
+    const int32_t nConvexHulls = static_cast<int32_t>(m_leafHulls.Size());
+    const int32_t maxConvexHulls = static_cast<int32_t>(params.m_maxConvexHulls);
+    std::vector<const ConvexHullMesh*> hulls(m_leafHulls.Data(), m_leafHulls.Data() + nConvexHulls);
+    std::vector<uint32_t> versions(nConvexHulls, 0);
+    std::vector<char> alive(nConvexHulls, 1);
+    std::vector<int32_t> positions(nConvexHulls);
+    std::vector<int32_t> slots(nConvexHulls);
+    for (int32_t p = 0; p < nConvexHulls; ++p) {
+        positions[p] = slots[p] = p;
+    }
+    int32_t nAlive = nConvexHulls;
+    size_t nReplayed = 0;
+    for (; nReplayed < m_mergeHistory.size() && nAlive > maxConvexHulls; ++nReplayed) {
+        const HullMergeRecord& record = m_mergeHistory[nReplayed];
+        ApplyHullMerge(record, hulls, positions, slots);
+        alive[record.m_p2] = 0;
+        versions[record.m_p1] = static_cast<uint32_t>(nReplayed + 1);
+        --nAlive;
+    }
+    if (nReplayed > 0 && params.m_logger) {
+        msg.str("");
+        msg << "\t\t [Merge history] " << nReplayed << " merges replayed" << std::endl;
+        params.m_logger->Log(msg.str().c_str());
+    }
 	// Iteration counter
     int32_t iteration = 0;
-	// While we have more than at least one convex hull and the user has not asked us to cancel the operation
-    if (nConvexHulls > 1 && !m_cancel) 
+	// While we have more convex hulls than requested and the user has not asked us to cancel the operation
+    if (nAlive > maxConvexHulls && !GetCancel()) 
 	{
-		// Get the gamma error threshold for when to exit
+        Vec3<double> globalMinBB;
+        Vec3<double> globalMaxBB;
+        // the lazy mode bounds the merge costs with the k-DOP extreme points of the hulls
+        const bool lazy = params.m_lazyHullMerge;
         SArray<Vec3<double> > pts;
-        Mesh combinedCH;
-
-        // Populate the cost matrix
-        size_t idx = 0;
-        SArray<float> costMatrix;
-        costMatrix.Resize(((nConvexHulls * nConvexHulls) - nConvexHulls) >> 1);
-        for (size_t p1 = 1; p1 < nConvexHulls; ++p1) 
-		{
-            const float volume1 = m_convexHulls[p1]->ComputeVolume();
-            for (size_t p2 = 0; p2 < p1; ++p2) 
-			{
-                ComputeConvexHull(m_convexHulls[p1], m_convexHulls[p2], pts, &combinedCH);
-                costMatrix[idx++] = ComputeConcavity(volume1 + m_convexHulls[p2]->ComputeVolume(), combinedCH.ComputeVolume(), m_volumeCH0);
+        SArray<Vec3<double> > hullExtremePts;
+        std::vector<Vec3<double> > extremePts(lazy ? nConvexHulls * g_nKDOPExtremePoints : 0);
+        std::vector<int32_t> nExtremePts(lazy ? nConvexHulls : 0, 0);
+        for (int32_t p = 0; p < nConvexHulls; ++p) {
+            const ConvexHullMesh* const ch = m_leafHulls[p];
+            if (lazy && alive[p]) {
+                pts.Resize(0);
+                AddPoints(hulls[p], pts);
+                ComputeExtremePoints(pts, hullExtremePts);
+                nExtremePts[p] = static_cast<int32_t>(hullExtremePts.Size());
+                std::copy(hullExtremePts.Data(), hullExtremePts.Data() + nExtremePts[p], extremePts.begin() + p * g_nKDOPExtremePoints);
+            }
+            for (int32_t h = 0; h < 3; ++h) {
+                globalMinBB[h] = (p == 0) ? ch->GetMinBB()[h] : std::min(globalMinBB[h], ch->GetMinBB()[h]);
+                globalMaxBB[h] = (p == 0) ? ch->GetMaxBB()[h] : std::max(globalMaxBB[h], ch->GetMaxBB()[h]);
+            }
+        }
+        // the sparse mode only considers the pairs of hulls whose enlarged bounding boxes overlap
+        const bool sparse = params.m_sparseHullMerge;
+        const double diagBB = (globalMaxBB - globalMinBB).GetNorm();
+        double tolerance = (m_mergeHistory.empty()) ? params.m_mergeAABBTolerance * diagBB : m_mergeTolerance;
+
+        HullMergeQueue queue;
+        HullMergeCandidate candidate;
+        std::vector<HullMergeCandidate> candidates;
+        std::vector<HullMergeCandidate> ties;
+        size_t nCostEvaluations = 0;
+        size_t nCostBounds = 0;
+
+        // Populate the merge queue
+        for (int32_t p1 = 0; p1 < nConvexHulls; ++p1) {
+            for (int32_t p2 = p1 + 1; p2 < nConvexHulls && alive[p1]; ++p2) {
+                if (alive[p2] && (!sparse || OverlapAABB(hulls[p1], hulls[p2], tolerance))) {
+                    candidate.m_p1 = p1;
+                    candidate.m_p2 = p2;
+                    candidate.m_version1 = versions[p1];
+                    candidate.m_version2 = versions[p2];
+                    candidates.push_back(candidate);
+                }
             }
         }
+        ComputeMergeCosts(candidates, hulls, extremePts, nExtremePts, lazy);
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            queue.push(candidates[c]);
+        }
+        (lazy ? nCostBounds : nCostEvaluations) += candidates.size();
+        if (sparse && params.m_logger) {
+            msg.str("");
+            msg << "\t\t [Sparse merge] " << candidates.size() << " neighbouring pairs out of " << ((nAlive * (nAlive - 1)) >> 1) << std::endl;
+            params.m_logger->Log(msg.str().c_str());
+        }
 
-        // Until we cant merge below the maximum cost
-        size_t costSize = m_convexHulls.Size();
-        while (!m_cancel) 
+        // Until we reach the maximum number of convex hulls
+        while (!GetCancel() && nAlive > maxConvexHulls)
 		{
             msg.str("");
             msg << "Iteration " << iteration++;
             m_operation = msg.str();
 
-            // Search for lowest cost
-            float bestCost = (std::numeric_limits<float>::max)();
-            const size_t addr = FindMinimumElement(costMatrix.Data(), &bestCost, 0, costMatrix.Size());
-			if ( (costSize-1) < params.m_maxConvexHulls)
-			{
-				break;
-			}
-            const size_t addrI = (static_cast<int32_t>(sqrt(1 + (8 * addr))) - 1) >> 1;
-            const size_t p1 = addrI + 1;
-            const size_t p2 = addr - ((addrI * (addrI + 1)) >> 1);
-            assert(p1 >= 0);
-            assert(p2 >= 0);
-            assert(p1 < costSize);
-            assert(p2 < costSize);
+            // Discard the candidates invalidated by previous merges. In lazy mode, the bounded candidates reaching the
+            // top are evaluated and queued again: the lowest cost pair is found once an exact cost is on top
+            while (!queue.empty()) {
+                const HullMergeCandidate& top = queue.top();
+                if (alive[top.m_p1] && alive[top.m_p2] && versions[top.m_p1] == top.m_version1 && versions[top.m_p2] == top.m_version2) {
+                    if (top.m_exact) {
+                        break;
+                    }
+                    candidate = top;
+                    queue.pop();
+                    candidate.m_cost = (float)ComputeMergeCost(candidate, hulls, m_workspaces[0]);
+                    candidate.m_exact = true;
+                    queue.push(candidate);
+                    ++nCostEvaluations;
+                    continue;
+                }
+                queue.pop();
+            }
+            if (queue.empty()) {
+                // no neighbouring hulls left (sparse mode): enlarge the bounding boxes until some pairs overlap
+                // (once they cover the whole object, all the pairs of remaining hulls are candidates)
+                tolerance = (tolerance > 0.0) ? 2.0 * tolerance : 0.01 * diagBB;
+                if (params.m_logger) {
+                    msg.str("");
+                    msg << "\t\t [Sparse merge] no neighbouring hulls, tolerance increased to " << tolerance << std::endl;
+                    params.m_logger->Log(msg.str().c_str());
+                }
+                candidates.clear();
+                for (int32_t p1 = 0; p1 < nConvexHulls; ++p1) {
+                    for (int32_t p2 = p1 + 1; p2 < nConvexHulls && alive[p1]; ++p2) {
+                        if (alive[p2] && OverlapAABB(hulls[p1], hulls[p2], tolerance)) {
+                            candidate.m_p1 = p1;
+                            candidate.m_p2 = p2;
+                            candidate.m_version1 = versions[p1];
+                            candidate.m_version2 = versions[p2];
+                            candidates.push_back(candidate);
+                        }
+                    }
+                }
+                ComputeMergeCosts(candidates, hulls, extremePts, nExtremePts, lazy);
+                for (size_t c = 0; c < candidates.size(); ++c) {
+                    queue.push(candidates[c]);
+                }
+                (lazy ? nCostBounds : nCostEvaluations) += candidates.size();
+                continue;
+            }
 
+            // Lowest cost pair. Ties (e.g. the zero costs of nested hulls) go to the first pair in the order of the
+            // hull positions, as in the former cost matrix search
+            const float bestCost = queue.top().m_cost;
+            ties.clear();
+            while (!queue.empty() && queue.top().m_cost == bestCost) {
+                candidate = queue.top();
+                queue.pop();
+                if (!alive[candidate.m_p1] || !alive[candidate.m_p2] || versions[candidate.m_p1] != candidate.m_version1 || versions[candidate.m_p2] != candidate.m_version2) {
+                    continue;
+                }
+                if (!candidate.m_exact) {
+                    candidate.m_cost = (float)ComputeMergeCost(candidate, hulls, m_workspaces[0]);
+                    candidate.m_exact = true;
+                    queue.push(candidate);
+                    ++nCostEvaluations;
+                    continue;
+                }
+                ties.push_back(candidate);
+            }
+            size_t iBest = 0;
+            for (size_t t = 1; t < ties.size(); ++t) {
+                const int32_t hi = std::max(positions[ties[t].m_p1], positions[ties[t].m_p2]);
+                const int32_t lo = std::min(positions[ties[t].m_p1], positions[ties[t].m_p2]);
+                const int32_t hiBest = std::max(positions[ties[iBest].m_p1], positions[ties[iBest].m_p2]);
+                const int32_t loBest = std::min(positions[ties[iBest].m_p1], positions[ties[iBest].m_p2]);
+                if (hi < hiBest || (hi == hiBest && lo < loBest)) {
+                    iBest = t;
+                }
+            }
+            for (size_t t = 0; t < ties.size(); ++t) {
+                if (t != iBest) {
+                    queue.push(ties[t]);
+                }
+            }
+            const HullMergeCandidate best = ties[iBest];
+            const int32_t p1 = best.m_p1;
+            const int32_t p2 = best.m_p2;
+            // the hulls are combined from the higher position to the lower one
+            const int32_t pHi = (positions[p1] > positions[p2]) ? p1 : p2;
+            const int32_t pLo = (pHi == p1) ? p2 : p1;
             if (params.m_logger) 
 			{
                 msg.str("");
-                msg << "\t\t Merging (" << p1 << ", " << p2 << ") " << bestCost << std::endl
+                msg << "\t\t Merging (" << positions[pHi] << ", " << positions[pLo] << ") " << best.m_cost << std::endl
                     << std::endl;
                 params.m_logger->Log(msg.str().c_str());
             }
 
-            // Make the lowest cost row and column into a new hull
-            Mesh* cch = new Mesh;
-            ComputeConvexHull(m_convexHulls[p1], m_convexHulls[p2], pts, cch);
-            delete m_convexHulls[p2];
-            m_convexHulls[p2] = cch;
-
-            delete m_convexHulls[p1];
-            std::swap(m_convexHulls[p1], m_convexHulls[m_convexHulls.Size() - 1]);
-            m_convexHulls.PopBack();
-
-            costSize = costSize - 1;
+            // Make the lowest cost pair into a new hull, which takes the place of p1, and record the merge
+            Mesh combinedCH;
+            ComputeConvexHull(hulls[pHi], hulls[pLo], pts, &combinedCH, &m_workspaces[0].m_hullComputer);
+            HullMergeRecord record;
+            record.m_p1 = p1;
+            record.m_p2 = p2;
+            record.m_hull = new ConvexHullMesh(std::move(combinedCH));
+            m_mergeHistory.push_back(record);
+            const ConvexHullMesh* const cch = record.m_hull;
+            ApplyHullMerge(record, hulls, positions, slots);
+            alive[p2] = 0;
+            versions[p1] = static_cast<uint32_t>(m_mergeHistory.size());
+            --nAlive;
+            if (lazy) {
+                pts.Resize(0);
+                AddPoints(cch, pts);
+                ComputeExtremePoints(pts, hullExtremePts);
+                nExtremePts[p1] = static_cast<int32_t>(hullExtremePts.Size());
+                std::copy(hullExtremePts.Data(), hullExtremePts.Data() + nExtremePts[p1], extremePts.begin() + p1 * g_nKDOPExtremePoints);
+            }
 
             // Calculate costs versus the new hull
-            size_t rowIdx = ((p2 - 1) * p2) >> 1;
-            const float volume1 = m_convexHulls[p2]->ComputeVolume();
-            for (size_t i = 0; (i < p2) && (!m_cancel); ++i) 
-			{
-                ComputeConvexHull(m_convexHulls[p2], m_convexHulls[i], pts, &combinedCH);
-                costMatrix[rowIdx++] = ComputeConcavity(volume1 + m_convexHulls[i]->ComputeVolume(), combinedCH.ComputeVolume(), m_volumeCH0);
+            candidates.clear();
+            for (int32_t q = 0; q < nConvexHulls; ++q) {
+                if (q != p1 && alive[q] && (!sparse || OverlapAABB(cch, hulls[q], tolerance))) {
+                    candidate.m_p1 = std::min(p1, q);
+                    candidate.m_p2 = std::max(p1, q);
+                    candidate.m_version1 = versions[candidate.m_p1];
+                    candidate.m_version2 = versions[candidate.m_p2];
+                    candidates.push_back(candidate);
+                }
             }
-
-            rowIdx += p2;
-            for (size_t i = p2 + 1; (i < costSize) && (!m_cancel); ++i) 
-			{
-                ComputeConvexHull(m_convexHulls[p2], m_convexHulls[i], pts, &combinedCH);
-                costMatrix[rowIdx] = ComputeConcavity(volume1 + m_convexHulls[i]->ComputeVolume(), combinedCH.ComputeVolume(), m_volumeCH0);
-                rowIdx += i;
-                assert(rowIdx >= 0);
+            ComputeMergeCosts(candidates, hulls, extremePts, nExtremePts, lazy);
+            for (size_t c = 0; c < candidates.size(); ++c) {
+                queue.push(candidates[c]);
             }
+            (lazy ? nCostBounds : nCostEvaluations) += candidates.size();
+        }
 
-            // Move the top column in to replace its space
-            const size_t erase_idx = ((costSize - 1) * costSize) >> 1;
-            if (p1 < costSize) {
-                rowIdx = (addrI * p1) >> 1;
-                size_t top_row = erase_idx;
-                for (size_t i = 0; i < p1; ++i) {
-                    if (i != p2) {
-                        costMatrix[rowIdx] = costMatrix[top_row];
-                    }
-                    ++rowIdx;
-                    ++top_row;
-                }
-
-                ++top_row;
-                rowIdx += p1;
-                for (size_t i = p1 + 1; i < (costSize + 1); ++i) {
-                    costMatrix[rowIdx] = costMatrix[top_row++];
-                    rowIdx += i;
-                    assert(rowIdx >= 0);
-                }
+        m_mergeTolerance = tolerance;
+        if (params.m_logger) {
+            msg.str("");
+            msg << "\t # merge costs evaluated     " << nCostEvaluations << std::endl;
+            if (lazy) {
+                msg << "\t # merge cost bounds         " << nCostBounds << " (" << ((nCostBounds > 0) ? 100.0 * (1.0 - (double)nCostEvaluations / nCostBounds) : 0.0)
+                    << "% of the exact evaluations skipped)" << std::endl;
             }
-            costMatrix.Resize(erase_idx);
+            params.m_logger->Log(msg.str().c_str());
         }
     }
+
     m_overallProgress = 99.0;
     Update(100.0, 100.0, params);
     m_timer.Toc();
@@ -1418,12 +2161,83 @@ void VHACD::MergeConvexHulls(const Parameters& params)
         params.m_logger->Log(msg.str().c_str());
     }
 }
-void VHACD::SimplifyConvexHull(Mesh* const ch, const size_t nvertices, const double minVolume)
+void VHACD::CopyMergedHulls(const uint32_t maxConvexHulls, SArray<ConvexHullMesh*>& output) const
+{
+    // Replays the merge history until at most maxConvexHulls hulls remain, and copies them to the output (the
+    // leaves and the merge history are kept for Remerge() and ComputeLODs())
+    for (size_t p = 0; p < output.Size(); ++p) {
+        delete output[p];
+    }
+    output.Resize(0);
+    const int32_t nConvexHulls = static_cast<int32_t>(m_leafHulls.Size());
+    std::vector<const ConvexHullMesh*> hulls(m_leafHulls.Data(), m_leafHulls.Data() + nConvexHulls);
+    std::vector<int32_t> positions(nConvexHulls);
+    std::vector<int32_t> slots(nConvexHulls);
+    for (int32_t p = 0; p < nConvexHulls; ++p) {
+        positions[p] = slots[p] = p;
+    }
+    int32_t nAlive = nConvexHulls;
+    for (size_t m = 0; m < m_mergeHistory.size() && nAlive > static_cast<int32_t>(maxConvexHulls); ++m) {
+        ApplyHullMerge(m_mergeHistory[m], hulls, positions, slots);
+        --nAlive;
+    }
+    for (size_t p = 0; p < slots.size(); ++p) {
+        output.PushBack(new ConvexHullMesh(*hulls[slots[p]]));
+    }
+}
+bool VHACD::Remerge(const uint32_t maxConvexHulls)
+{
+    if (m_leafHulls.Size() == 0) {
+        return false;
+    }
+    SetCancel(false);
+    Parameters params = m_params;
+    params.m_maxConvexHulls = maxConvexHulls;
+    MergeConvexHulls(params);
+    CopyMergedHulls(maxConvexHulls, m_convexHulls);
+    SimplifyConvexHulls(&m_convexHulls, 1, params);
+    return !GetCancel();
+}
+bool VHACD::ComputeLODs(const uint32_t* const maxConvexHulls, const uint32_t nLODs)
 {
-    if (nvertices <= 4) {
+    ReleaseLODs();
+    if (m_leafHulls.Size() == 0 || nLODs == 0) {
+        return false;
+    }
+    SetCancel(false);
+    // A single merge pass down to the coarsest level of detail records every intermediate hull count in the merge
+    // history, from which the finer levels are snapshotted
+    Parameters params = m_params;
+    params.m_maxConvexHulls = *std::min_element(maxConvexHulls, maxConvexHulls + nLODs);
+    MergeConvexHulls(params);
+    if (GetCancel()) {
+        return false;
+    }
+    m_lodConvexHulls.resize(nLODs);
+    for (uint32_t l = 0; l < nLODs; ++l) {
+        CopyMergedHulls(maxConvexHulls[l], m_lodConvexHulls[l]);
+        if (params.m_logger) {
+            std::ostringstream msg;
+            msg << "\t\t [LOD] " << l << ": " << m_lodConvexHulls[l].Size() << " convex-hulls (max " << maxConvexHulls[l] << ")" << std::endl;
+            params.m_logger->Log(msg.str().c_str());
+        }
+    }
+    SimplifyConvexHulls(m_lodConvexHulls.data(), nLODs, params);
+    if (GetCancel()) {
+        ReleaseLODs();
+        return false;
+    }
+    return true;
+}
+void VHACD::SimplifyConvexHull(Mesh* const ch, const size_t nvertices, const double minVolume, PlaneEvaluationWorkspace& workspace)
+{
+    // empty hulls (e.g. clusters without enough points) are kept as they are: the copy of an empty mesh has no point
+    // buffer to project
+    if (nvertices <= 4 || ch->GetNPoints() == 0) {
         return;
     }
-    ICHull icHull;
+    IndexedICHull& icHull = workspace.m_icHull;
+    icHull.Clear();
     if (mRaycastMesh)
     {
         // We project these points onto the original source mesh to increase precision
@@ -1447,71 +2261,60 @@ void VHACD::SimplifyConvexHull(Mesh* const ch, const size_t nvertices, const dou
         // If a new point is within 1/100th the diagonal length of the bounding volume we do not add it.  To do so would create a
         // thin sliver in the resulting convex hull
         double snapDistanceThreshold = diagonalLength * 0.01;
-        double snapDistanceThresholdSquared = snapDistanceThreshold*snapDistanceThreshold;
 
-        // Allocate buffer for projected vertices
-        Vec3<double> *outputPoints = new Vec3<double>[nPoints];
-        uint32_t outCount = 0;
+        // The rays of all the vertices are cast in a single batch
+        workspace.m_rayTargets.Resize(nPoints);
+        workspace.m_rayHits.Resize(nPoints);
+        workspace.m_rayHitDistances.Resize(nPoints);
+        workspace.m_rayHitFlags.Resize(nPoints);
         for (uint32_t i = 0; i < nPoints; i++)
         {
-            Vec3<double> &inputPoint = inputPoints[i];
-            Vec3<double> &outputPoint = outputPoints[outCount];
             // Compute the direction vector from the center of this mesh to the vertex
-            Vec3<double> dir = inputPoint - center;
+            Vec3<double> dir = inputPoints[i] - center;
             // Normalize the direction vector.
             dir.Normalize();
             // Multiply times the diagonal length of the mesh
             dir *= diagonalLength;
             // Add the center back in again to get the destination point
             dir += center;
+            workspace.m_rayTargets[i] = dir;
+        }
+        mRaycastMesh->raycastBatch(nPoints, center.GetData(), workspace.m_rayTargets.Data()->GetData(), inputPoints->GetData(),
+            workspace.m_rayHits.Data()->GetData(), workspace.m_rayHitDistances.Data(), workspace.m_rayHitFlags.Data());
+
+        // Ok, before we add a point, we do not want to create points which are extremely close to each other.
+        // This will result in tiny sliver triangles which are really bad for collision detection.
+        // A point closer than the snap distance to an already added point is welded to it (not added).
+        PointWelder& welder = workspace.m_pointWelder;
+        welder.Reset(snapDistanceThreshold, nPoints);
+        for (uint32_t i = 0; i < nPoints; i++)
+        {
             // By default the output point is equal to the input point
-            outputPoint = inputPoint;
-            double pointDistance;
-            if (mRaycastMesh->raycast(center.GetData(), dir.GetData(), inputPoint.GetData(), outputPoint.GetData(),&pointDistance) )
-            {
-                // If the nearest intersection point is too far away, we keep the original source data point.
-                // Not all points lie directly on the original mesh surface
-                if (pointDistance > pointDistanceThreshold)
-                {
-                    outputPoint = inputPoint;
-                }
-            }
-            // Ok, before we add this point, we do not want to create points which are extremely close to each other.
-            // This will result in tiny sliver triangles which are really bad for collision detection.
-            bool foundNearbyPoint = false;
-            for (uint32_t j = 0; j < outCount; j++)
+            Vec3<double> outputPoint(inputPoints[i]);
+            // If the nearest intersection point is too far away, we keep the original source data point.
+            // Not all points lie directly on the original mesh surface
+            if (workspace.m_rayHitFlags[i] && workspace.m_rayHitDistances[i] <= pointDistanceThreshold)
             {
-                // If this new point is extremely close to an existing point, we do not add it!
-                double squaredDistance = outputPoints[j].GetDistanceSquared(outputPoint);
-                if (squaredDistance < snapDistanceThresholdSquared )
-                {
-                    foundNearbyPoint = true;
-                    break;
-                }
-            }
-            if (!foundNearbyPoint)
-            {
-                outCount++;
+                outputPoint = workspace.m_rayHits[i];
             }
+            welder.Weld(outputPoint);
         }
-        icHull.AddPoints(outputPoints, outCount);
-        delete[]outputPoints;
+        icHull.AddPoints(welder.GetPoints(), welder.GetNPoints());
     }
     else
     {
         icHull.AddPoints(ch->GetPointsBuffer(), ch->GetNPoints());
     }
     icHull.Process((uint32_t)nvertices, minVolume);
-    TMMesh& mesh = icHull.GetMesh();
-    const size_t nT = mesh.GetNTriangles();
-    const size_t nV = mesh.GetNVertices();
+    const size_t nT = icHull.GetNTriangles();
+    const size_t nV = icHull.GetNVertices();
     ch->ResizePoints(nV);
     ch->ResizeTriangles(nT);
-    mesh.GetIFS(ch->GetPointsBuffer(), ch->GetTrianglesBuffer());
+    icHull.GetIFS(ch->GetPointsBuffer(), ch->GetTrianglesBuffer());
 }
-void VHACD::SimplifyConvexHulls(const Parameters& params)
+void VHACD::SimplifyConvexHulls(SArray<ConvexHullMesh*>* const hullSets, const size_t nHullSets, const Parameters& params)
 {
-    if (m_cancel || params.m_maxNumVerticesPerCH < 4) {
+    if (GetCancel() || params.m_maxNumVerticesPerCH < 4) {
         return;
     }
     m_timer.Tic();
@@ -1519,21 +2322,41 @@ void VHACD::SimplifyConvexHulls(const Parameters& params)
     m_stage = "Simplify convex-hulls";
     m_operation = "Simplify convex-hulls";
 
+    // The hulls of all the sets are simplified independently of each other, each thread reusing the convex-hull
+    // of its workspace, and written back to their own slots, so the output order does not depend on the scheduling
+    std::vector<ConvexHullMesh**> hulls;
+    for (size_t s = 0; s < nHullSets; ++s) {
+        for (size_t i = 0; i < hullSets[s].Size(); ++i) {
+            hulls.push_back(&hullSets[s][i]);
+        }
+    }
     std::ostringstream msg;
-    const size_t nConvexHulls = m_convexHulls.Size();
+    const int32_t nConvexHulls = static_cast<int32_t>(hulls.size());
     if (params.m_logger) {
         msg << "+ Simplify " << nConvexHulls << " convex-hulls " << std::endl;
+        for (int32_t i = 0; i < nConvexHulls; ++i) {
+            msg << "\t\t Simplify CH[" << std::setfill('0') << std::setw(5) << i << "] " << (*hulls[i])->GetNPoints() << " V, " << (*hulls[i])->GetNTriangles() << " T" << std::endl;
+        }
         params.m_logger->Log(msg.str().c_str());
     }
 
     Update(0.0, 0.0, params);
-    for (size_t i = 0; i < nConvexHulls && !m_cancel; ++i) {
-        if (params.m_logger) {
-            msg.str("");
-            msg << "\t\t Simplify CH[" << std::setfill('0') << std::setw(5) << i << "] " << m_convexHulls[i]->GetNPoints() << " V, " << m_convexHulls[i]->GetNTriangles() << " T" << std::endl;
-            params.m_logger->Log(msg.str().c_str());
+#if USE_THREAD == 1 && _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int32_t i = 0; i < nConvexHulls; ++i) {
+        if (GetCancel()) {
+            continue;
         }
-        SimplifyConvexHull(m_convexHulls[i], params.m_maxNumVerticesPerCH, m_volumeCH0 * params.m_minVolumePerCH);
+        int32_t threadID = 0;
+#if USE_THREAD == 1 && _OPENMP
+        threadID = omp_get_thread_num();
+#endif
+        ConvexHullMesh*& hull = *hulls[i];
+        Mesh ch(hull->GetMesh());
+        SimplifyConvexHull(&ch, params.m_maxNumVerticesPerCH, m_volumeCH0 * params.m_minVolumePerCH, m_workspaces[threadID]);
+        delete hull;
+        hull = new ConvexHullMesh(std::move(ch));
     }
 
     m_overallProgress = 100.0;
@@ -1566,21 +2389,18 @@ bool VHACD::ComputeCenterOfMass(double centerOfMass[3]) const
 		// Compute the total volume of all convex hulls
 		for (uint32_t i = 0; i < hullCount; i++)
 		{
-			ConvexHull ch;
-			GetConvexHull(i, ch);
-			totalVolume += ch.m_volume;
+			totalVolume += m_convexHulls[i]->GetVolume();
 		}
 		// compute the reciprocal of the total volume
 		double recipVolume = 1.0 / totalVolume;
 		// Add in the weighted by volume average of the center point of each convex hull
 		for (uint32_t i = 0; i < hullCount; i++)
 		{
-			ConvexHull ch;
-			GetConvexHull(i, ch);
-			double ratio = ch.m_volume*recipVolume;
-			centerOfMass[0] += ch.m_center[0] * ratio;
-			centerOfMass[1] += ch.m_center[1] * ratio;
-			centerOfMass[2] += ch.m_center[2] * ratio;
+			const ConvexHullMesh* hull = m_convexHulls[i];
+			double ratio = hull->GetVolume()*recipVolume;
+			centerOfMass[0] += hull->GetCenter()[0] * ratio;
+			centerOfMass[1] += hull->GetCenter()[1] * ratio;
+			centerOfMass[2] += hull->GetCenter()[2] * ratio;
 		}
 	}
 	return ret;
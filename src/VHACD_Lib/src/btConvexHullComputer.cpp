@@ -18,6 +18,8 @@ subject to the following restrictions:
 #include "btConvexHullComputer.h"
 #include "btMinMax.h"
 #include "btVector3.h"
+#include "vhacdHullPointFilter.h"
+#include "vhacdQuickHull.h"
 
 #ifdef __GNUC__
 #include <stdint.h>
@@ -49,6 +51,17 @@ typedef unsigned long long int32_t uint64_t;
 #include <stdio.h>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Hulls whose divide-and-conquer recursion splits ranges of at least this many points compute the top levels of the
+// recursion in parallel (only when not already called from a parallel region)
+#ifndef BT_CONVEX_HULL_PARALLEL_CUTOFF
+#define BT_CONVEX_HULL_PARALLEL_CUTOFF 65536
+#endif
+#define BT_CONVEX_HULL_MAX_PARALLEL_LEVELS 6
+
 // Convex hull implementation based on Preparata and Hong
 // Ole Kniemeyer, MAXON Computer GmbH
 class btConvexHullInternal {
@@ -673,13 +686,14 @@ private:
             btAlignedFree(array);
         }
 
-        T* init()
+        int32_t getSize() const
         {
-            T* o = array;
-            for (int32_t i = 0; i < size; i++, o++) {
-                o->next = (i + 1 < size) ? o + 1 : NULL;
-            }
-            return array;
+            return size;
+        }
+
+        T* getObject(int32_t index)
+        {
+            return array + index;
         }
     };
 
@@ -688,6 +702,8 @@ private:
     private:
         PoolArray<T>* arrays;
         PoolArray<T>* nextArray;
+        PoolArray<T>* currentArray;
+        int32_t usedObjects; // number of objects handed out from currentArray
         T* freeObjects;
         int32_t arraySize;
 
@@ -695,12 +711,19 @@ private:
         Pool()
             : arrays(NULL)
             , nextArray(NULL)
+            , currentArray(NULL)
+            , usedObjects(0)
             , freeObjects(NULL)
             , arraySize(256)
         {
         }
 
         ~Pool()
+        {
+            clear();
+        }
+
+        void clear()
         {
             while (arrays) {
                 PoolArray<T>* p = arrays;
@@ -708,14 +731,35 @@ private:
                 p->~PoolArray<T>();
                 btAlignedFree(p);
             }
+            nextArray = NULL;
+            currentArray = NULL;
+            usedObjects = 0;
+            freeObjects = NULL;
         }
 
         void reset()
         {
             nextArray = arrays;
+            currentArray = NULL;
+            usedObjects = 0;
             freeObjects = NULL;
         }
 
+        // same as reset(), but guarantees that the next "size" objects are allocated contiguously. A too small array
+        // is replaced by one at least twice as large, so that hulls of growing sizes do not reallocate it every time
+        void reset(int32_t size)
+        {
+            if (arrays && arrays->getSize() < size) {
+                const int32_t grownSize = 2 * arrays->getSize();
+                clear();
+                arraySize = (grownSize > size) ? grownSize : size;
+            }
+            else if (!arrays && arraySize < size) {
+                arraySize = size;
+            }
+            reset();
+        }
+
         void setArraySize(int32_t arraySize)
         {
             this->arraySize = arraySize;
@@ -724,19 +768,26 @@ private:
         T* newObject()
         {
             T* o = freeObjects;
-            if (!o) {
-                PoolArray<T>* p = nextArray;
-                if (p) {
-                    nextArray = p->next;
-                }
-                else {
-                    p = new (btAlignedAlloc(sizeof(PoolArray<T>), 16)) PoolArray<T>(arraySize);
-                    p->next = arrays;
-                    arrays = p;
+            if (o) {
+                freeObjects = o->next;
+            }
+            else {
+                // objects are handed out sequentially, so that reusing large arrays for small hulls stays cheap
+                if (!currentArray || usedObjects == currentArray->getSize()) {
+                    PoolArray<T>* p = nextArray;
+                    if (p) {
+                        nextArray = p->next;
+                    }
+                    else {
+                        p = new (btAlignedAlloc(sizeof(PoolArray<T>), 16)) PoolArray<T>(arraySize);
+                        p->next = arrays;
+                        arrays = p;
+                    }
+                    currentArray = p;
+                    usedObjects = 0;
                 }
-                o = p->init();
+                o = currentArray->getObject(usedObjects++);
             }
-            freeObjects = o->next;
             return new (o) T();
         };
 
@@ -754,6 +805,7 @@ private:
     Pool<Edge> edgePool;
     Pool<Face> facePool;
     btAlignedObjectArray<Vertex*> originalVertices;
+    btAlignedObjectArray<Point32> points;
     int32_t mergeStamp;
     int32_t minAxis;
     int32_t medAxis;
@@ -801,6 +853,11 @@ private:
 
     void computeInternal(int32_t start, int32_t end, IntermediateHull& result);
 
+    // the recursion below the top 'levels' levels runs on one worker per range, each with its own edge pool and merge
+    // stamps, and the merges of the top levels run on the worker of their leftmost range
+    void computeParallel(int32_t levels, IntermediateHull& result);
+    btAlignedObjectArray<btConvexHullInternal*> workers;
+
     bool mergeProjection(IntermediateHull& h0, IntermediateHull& h1, Vertex*& c0, Vertex*& c1);
 
     void merge(IntermediateHull& h0, IntermediateHull& h1);
@@ -813,12 +870,15 @@ private:
 
 public:
     Vertex* vertexList;
+    btAlignedObjectArray<Vertex*> copiedVertices;
 
     void compute(const void* coords, bool doubleCoords, int32_t stride, int32_t count);
 
     btVector3 getCoordinates(const Vertex* v);
 
     btScalar shrink(btScalar amount, btScalar clampAmount);
+
+    ~btConvexHullInternal();
 };
 
 btConvexHullInternal::Int128 btConvexHullInternal::Int128::operator*(int64_t b) const
@@ -985,6 +1045,75 @@ btConvexHullInternal::Edge* btConvexHullInternal::newEdgePair(Vertex* from, Vert
     return e;
 }
 
+void btConvexHullInternal::computeParallel(int32_t levels, IntermediateHull& result)
+{
+    // the ranges are split exactly as computeInternal() splits them, so that the same hulls are merged in the same
+    // order as by the sequential recursion
+    const int32_t nTasks = 1 << levels;
+    int32_t starts[1 << BT_CONVEX_HULL_MAX_PARALLEL_LEVELS];
+    int32_t ends[1 << BT_CONVEX_HULL_MAX_PARALLEL_LEVELS];
+    IntermediateHull hulls[1 << BT_CONVEX_HULL_MAX_PARALLEL_LEVELS];
+    starts[0] = 0;
+    ends[0] = originalVertices.size();
+    for (int32_t level = 0; level < levels; level++) {
+        for (int32_t t = (1 << level) - 1; t >= 0; t--) {
+            const int32_t start = starts[t];
+            const int32_t end = ends[t];
+            const int32_t split0 = start + (end - start) / 2;
+            Point32 p = originalVertices[split0 - 1]->point;
+            int32_t split1 = split0;
+            while ((split1 < end) && (originalVertices[split1]->point == p)) {
+                split1++;
+            }
+            starts[2 * t] = start;
+            ends[2 * t] = split0;
+            starts[2 * t + 1] = split1;
+            ends[2 * t + 1] = end;
+        }
+    }
+    while (workers.size() < nTasks) {
+        workers.push_back(new (btAlignedAlloc(sizeof(btConvexHullInternal), 16)) btConvexHullInternal());
+    }
+
+#pragma omp parallel for
+    for (int32_t t = 0; t < nTasks; t++) {
+        btConvexHullInternal& worker = *workers[t];
+        const int32_t n = ends[t] - starts[t];
+        worker.originalVertices.resize(n);
+        for (int32_t i = 0; i < n; i++) {
+            worker.originalVertices[i] = originalVertices[starts[t] + i];
+        }
+        worker.edgePool.reset();
+        worker.edgePool.setArraySize(6 * n);
+        worker.usedEdgePairs = 0;
+        worker.maxUsedEdgePairs = 0;
+        worker.mergeStamp = mergeStamp;
+        worker.computeInternal(0, n, hulls[t]);
+    }
+
+    // the edges of both hulls must be older than the ones created by their merge
+    for (int32_t step = 1; step < nTasks; step *= 2) {
+#pragma omp parallel for
+        for (int32_t t = 0; t < nTasks; t += 2 * step) {
+            btConvexHullInternal& worker = *workers[t];
+            if (workers[t + step]->mergeStamp < worker.mergeStamp) {
+                worker.mergeStamp = workers[t + step]->mergeStamp;
+            }
+            worker.merge(hulls[t], hulls[t + step]);
+        }
+    }
+    result = hulls[0];
+    mergeStamp = workers[0]->mergeStamp;
+}
+
+btConvexHullInternal::~btConvexHullInternal()
+{
+    for (int32_t i = 0; i < workers.size(); i++) {
+        workers[i]->~btConvexHullInternal();
+        btAlignedFree(workers[i]);
+    }
+}
+
 bool btConvexHullInternal::mergeProjection(IntermediateHull& h0, IntermediateHull& h1, Vertex*& c0, Vertex*& c1)
 {
     Vertex* v0 = h0.maxYx;
@@ -1813,7 +1942,6 @@ void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int32_
 
     center = (min + max) * btScalar(0.5);
 
-    btAlignedObjectArray<Point32> points;
     points.resize(count);
     ptr = (const char*)coords;
     if (doubleCoords) {
@@ -1842,8 +1970,7 @@ void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int32_
     }
     points.quickSort(pointCmp);
 
-    vertexPool.reset();
-    vertexPool.setArraySize(count);
+    vertexPool.reset(count); // computeInternal() relies on consecutive original vertices
     originalVertices.resize(count);
     for (int32_t i = 0; i < count; i++) {
         Vertex* v = vertexPool.newObject();
@@ -1853,18 +1980,34 @@ void btConvexHullInternal::compute(const void* coords, bool doubleCoords, int32_
         originalVertices[i] = v;
     }
 
-    points.clear();
+    points.resize(0);
 
     edgePool.reset();
     edgePool.setArraySize(6 * count);
 
+    facePool.reset();
+
     usedEdgePairs = 0;
     maxUsedEdgePairs = 0;
 
     mergeStamp = -3;
 
     IntermediateHull hull;
-    computeInternal(0, count, hull);
+    int32_t levels = 0;
+#ifdef _OPENMP
+    if (!omp_in_parallel()) {
+        const int32_t nThreads = omp_get_max_threads();
+        while ((levels < BT_CONVEX_HULL_MAX_PARALLEL_LEVELS) && ((2 << levels) <= nThreads) && ((count >> levels) >= BT_CONVEX_HULL_PARALLEL_CUTOFF)) {
+            levels++;
+        }
+    }
+#endif
+    if (levels > 0) {
+        computeParallel(levels, hull);
+    }
+    else {
+        computeInternal(0, count, hull);
+    }
     vertexList = hull.minXy;
 #ifdef DEBUG_CONVEX_HULL
     printf("max. edges %d (3v = %d)", maxUsedEdgePairs, 3 * count);
@@ -2370,6 +2513,16 @@ bool btConvexHullInternal::shiftFace(Face* face, btScalar amount, btAlignedObjec
     return true;
 }
 
+btConvexHullComputer::~btConvexHullComputer()
+{
+    if (internal) {
+        internal->~btConvexHullInternal();
+        btAlignedFree(internal);
+    }
+    delete quickHull;
+    delete pointFilter;
+}
+
 static int32_t getVertexCopy(btConvexHullInternal::Vertex* vertex, btAlignedObjectArray<btConvexHullInternal::Vertex*>& vertices)
 {
     int32_t index = vertex->copy;
@@ -2384,6 +2537,76 @@ static int32_t getVertexCopy(btConvexHullInternal::Vertex* vertex, btAlignedObje
     return index;
 }
 
+VHACD::QuickHull& btConvexHullComputer::getQuickHull()
+{
+    if (!quickHull) {
+        quickHull = new VHACD::QuickHull();
+    }
+    return *quickHull;
+}
+
+VHACD::HullPointFilter& btConvexHullComputer::getPointFilter()
+{
+    if (!pointFilter) {
+        pointFilter = new VHACD::HullPointFilter();
+    }
+    return *pointFilter;
+}
+
+void btConvexHullComputer::copyQuickHull(const void* coords, int32_t stride)
+{
+    const VHACD::QuickHull& hull = *quickHull;
+    const int32_t nv = hull.GetNVertices();
+    const int32_t nf = hull.GetNFaces();
+    vertices.resize(nv);
+    for (int32_t v = 0; v < nv; v++) {
+        const double* p = (const double*)((const char*)coords + (size_t)hull.GetVertex(v) * stride);
+        vertices[v] = btVector3((btScalar)p[0], (btScalar)p[1], (btScalar)p[2]);
+    }
+    // output edge of each half-edge of the polygons; twins are stored next to each other
+    int32_t nh = 0;
+    for (int32_t f = 0; f < nf; f++) {
+        nh += hull.GetFaceSize(f);
+    }
+    btAlignedObjectArray<int32_t>& edgeIndices = quickHullEdges;
+    edgeIndices.resize(nh);
+    for (int32_t h = 0; h < nh; h++) {
+        edgeIndices[h] = -1;
+    }
+    edges.resize(nh);
+    int32_t nEdges = 0;
+    for (int32_t f = 0; f < nf; f++) {
+        const int32_t* face = hull.GetFace(f);
+        const int32_t size = hull.GetFaceSize(f);
+        const int32_t h0 = hull.GetFaceEdge(f);
+        for (int32_t i = 0; i < size; i++) {
+            if (edgeIndices[h0 + i] >= 0) {
+                continue;
+            }
+            edgeIndices[h0 + i] = nEdges;
+            edgeIndices[hull.GetTwinEdge(h0 + i)] = nEdges + 1;
+            edges[nEdges].reverse = 1;
+            edges[nEdges].targetVertex = face[(i + 1) % size];
+            edges[nEdges + 1].reverse = -1;
+            edges[nEdges + 1].targetVertex = face[i];
+            nEdges += 2;
+        }
+    }
+    // the next edge around the source vertex of an edge follows its reverse edge in the reverse edge's face
+    for (int32_t f = 0; f < nf; f++) {
+        const int32_t size = hull.GetFaceSize(f);
+        const int32_t h0 = hull.GetFaceEdge(f);
+        for (int32_t i = 0; i < size; i++) {
+            const int32_t e = edgeIndices[hull.GetTwinEdge(h0 + i)];
+            edges[e].next = edgeIndices[h0 + (i + 1) % size] - e;
+        }
+    }
+    faces.resize(nf);
+    for (int32_t f = 0; f < nf; f++) {
+        faces[f] = edgeIndices[hull.GetFaceEdge(f)];
+    }
+}
+
 btScalar btConvexHullComputer::compute(const void* coords, bool doubleCoords, int32_t stride, int32_t count, btScalar shrink, btScalar shrinkClamp)
 {
     if (count <= 0) {
@@ -2393,7 +2616,25 @@ btScalar btConvexHullComputer::compute(const void* coords, bool doubleCoords, in
         return 0;
     }
 
-    btConvexHullInternal hull;
+    if (usePointFilter && doubleCoords && getPointFilter().Filter((const double*)coords, stride, count)) {
+        coords = pointFilter->GetPoints();
+        stride = 3 * sizeof(double);
+        count = pointFilter->GetNPoints();
+    }
+
+    if (useQuickHull && doubleCoords && (shrink <= 0)) {
+        if (getQuickHull().Compute((const double*)coords, stride, count)) {
+            copyQuickHull(coords, stride);
+            return 0;
+        }
+    }
+
+    // the internal hull (and its vertex/edge pools) is kept alive between calls so that
+    // computing many hulls with the same object does not hit the heap once warmed up
+    if (!internal) {
+        internal = new (btAlignedAlloc(sizeof(btConvexHullInternal), 16)) btConvexHullInternal();
+    }
+    btConvexHullInternal& hull = *internal;
     hull.compute(coords, doubleCoords, stride, count);
 
     btScalar shift = 0;
@@ -2408,7 +2649,8 @@ btScalar btConvexHullComputer::compute(const void* coords, bool doubleCoords, in
     edges.resize(0);
     faces.resize(0);
 
-    btAlignedObjectArray<btConvexHullInternal::Vertex*> oldVertices;
+    btAlignedObjectArray<btConvexHullInternal::Vertex*>& oldVertices = hull.copiedVertices;
+    oldVertices.resize(0);
     getVertexCopy(hull.vertexList, oldVertices);
     int32_t copied = 0;
     while (copied < oldVertices.size()) {
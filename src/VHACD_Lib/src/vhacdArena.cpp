@@ -0,0 +1,155 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vhacdArena.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace VHACD {
+Arena::Arena()
+{
+    m_chunk = 0;
+    m_offset = 0;
+    m_bytesInUse = 0;
+    m_nLiveBlocks = 0;
+    m_highWaterMark = 0;
+    m_reservedBytes = 0;
+    m_nAllocations = 0;
+    memset(m_freeBlocks, 0, sizeof(m_freeBlocks));
+}
+Arena::~Arena(void)
+{
+    Release();
+}
+int32_t Arena::GetSizeClass(const size_t size)
+{
+    int32_t sizeClass = 0;
+    size_t blockSize = ARENA_MIN_BLOCK_SIZE;
+    while (blockSize < size) {
+        blockSize <<= 1;
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+void* Arena::AllocateBlock(const int32_t sizeClass)
+{
+    const size_t blockSize = static_cast<size_t>(ARENA_MIN_BLOCK_SIZE) << sizeClass;
+    void* block = m_freeBlocks[sizeClass];
+    if (block) {
+        m_freeBlocks[sizeClass] = *static_cast<void**>(block);
+        return block;
+    }
+    // the end of a chunk too small for the block is left unused
+    while (m_chunk < m_chunks.size() && m_offset + blockSize > m_chunkSizes[m_chunk]) {
+        ++m_chunk;
+        m_offset = 0;
+    }
+    if (m_chunk == m_chunks.size()) {
+        const size_t chunkSize = (blockSize > ARENA_CHUNK_SIZE) ? blockSize : ARENA_CHUNK_SIZE;
+        char* const chunk = static_cast<char*>(malloc(chunkSize));
+        if (!chunk) {
+            return 0;
+        }
+        m_chunks.push_back(chunk);
+        m_chunkSizes.push_back(chunkSize);
+        m_reservedBytes += chunkSize;
+    }
+    block = m_chunks[m_chunk] + m_offset;
+    m_offset += blockSize;
+    return block;
+}
+void* Arena::Allocate(const size_t size)
+{
+    const int32_t sizeClass = GetSizeClass(size);
+    void* block;
+    if (sizeClass < ARENA_NUM_SIZE_CLASSES) {
+        block = AllocateBlock(sizeClass);
+        if (!block) {
+            return 0;
+        }
+        m_bytesInUse += static_cast<size_t>(ARENA_MIN_BLOCK_SIZE) << sizeClass;
+    }
+    else {
+        block = malloc(size);
+        if (!block) {
+            return 0;
+        }
+    }
+    ++m_nAllocations;
+    ++m_nLiveBlocks;
+    if (m_bytesInUse > m_highWaterMark) {
+        m_highWaterMark = m_bytesInUse;
+    }
+    return block;
+}
+void* Arena::Reallocate(void* const ptr, const size_t oldSize, const size_t newSize)
+{
+    const int32_t oldClass = GetSizeClass(oldSize);
+    const int32_t newClass = GetSizeClass(newSize);
+    if (oldClass == newClass && oldClass < ARENA_NUM_SIZE_CLASSES) {
+        return ptr;
+    }
+    if (oldClass >= ARENA_NUM_SIZE_CLASSES && newClass >= ARENA_NUM_SIZE_CLASSES) {
+        return realloc(ptr, newSize);
+    }
+    // on failure 'ptr' is left allocated
+    void* const block = Allocate(newSize);
+    if (!block) {
+        return 0;
+    }
+    memcpy(block, ptr, (oldSize < newSize) ? oldSize : newSize);
+    Free(ptr, oldSize);
+    return block;
+}
+void Arena::Free(void* const ptr, const size_t size)
+{
+    assert(m_nLiveBlocks > 0);
+    --m_nLiveBlocks;
+    const int32_t sizeClass = GetSizeClass(size);
+    if (sizeClass < ARENA_NUM_SIZE_CLASSES) {
+        *static_cast<void**>(ptr) = m_freeBlocks[sizeClass];
+        m_freeBlocks[sizeClass] = ptr;
+        m_bytesInUse -= static_cast<size_t>(ARENA_MIN_BLOCK_SIZE) << sizeClass;
+    }
+    else {
+        free(ptr);
+    }
+}
+bool Arena::Reset()
+{
+    m_highWaterMark = m_bytesInUse;
+    m_nAllocations = 0;
+    if (m_nLiveBlocks) {
+        return false;
+    }
+    m_chunk = 0;
+    m_offset = 0;
+    m_bytesInUse = 0;
+    memset(m_freeBlocks, 0, sizeof(m_freeBlocks));
+    return true;
+}
+void Arena::Release()
+{
+    m_nLiveBlocks = 0;
+    Reset();
+    for (size_t c = 0; c < m_chunks.size(); ++c) {
+        free(m_chunks[c]);
+    }
+    m_chunks.clear();
+    m_chunkSizes.clear();
+    m_reservedBytes = 0;
+    m_highWaterMark = 0;
+}
+}
@@ -0,0 +1,151 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vhacdHullPointFilter.h"
+#include <math.h>
+
+namespace VHACD {
+static const int32_t g_nFilterAxes = 13;
+static const double g_filterAxes[g_nFilterAxes][3] = {
+    { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 },
+    { 1.0, 1.0, 0.0 }, { 1.0, -1.0, 0.0 }, { 1.0, 0.0, 1.0 }, { 1.0, 0.0, -1.0 }, { 0.0, 1.0, 1.0 }, { 0.0, 1.0, -1.0 },
+    { 1.0, 1.0, 1.0 }, { 1.0, 1.0, -1.0 }, { 1.0, -1.0, 1.0 }, { 1.0, -1.0, -1.0 }
+};
+// number of points tested together against each face
+static const int32_t g_filterBlockSize = 64;
+// relative margin by which a point must be inside a face to be discarded, much larger than the rounding error of the
+// face planes and of the distances
+static const double g_filterTolerance = 1.0e-12;
+// btConvexHullInternal::compute() truncates the points to a grid of 10216 steps along each side of their bounding box,
+// computed in btScalar precision
+static const double g_quantizationSteps = 10216.0;
+static const double g_btScalarRoundoff = 1.0 / 1048576.0;
+
+HullPointFilter::HullPointFilter()
+{
+    m_nInputPoints = 0;
+    m_nRejectedPoints = 0;
+}
+void HullPointFilter::ResetCounters()
+{
+    m_nInputPoints = 0;
+    m_nRejectedPoints = 0;
+}
+bool HullPointFilter::Filter(const double* const points, const int32_t stride, const int32_t nPoints)
+{
+    m_nInputPoints += nPoints;
+    m_points.resize(0);
+    if (nPoints <= 2 * g_nFilterAxes) {
+        return false;
+    }
+    // extreme points along each axis
+    int32_t minIndex[g_nFilterAxes];
+    int32_t maxIndex[g_nFilterAxes];
+    double minProj[g_nFilterAxes];
+    double maxProj[g_nFilterAxes];
+    for (int32_t a = 0; a < g_nFilterAxes; ++a) {
+        minIndex[a] = maxIndex[a] = 0;
+        minProj[a] = maxProj[a] = g_filterAxes[a][0] * points[0] + g_filterAxes[a][1] * points[1] + g_filterAxes[a][2] * points[2];
+    }
+    double maxCoord = 0.0;
+    const char* pt = reinterpret_cast<const char*>(points);
+    for (int32_t p = 0; p < nPoints; ++p, pt += stride) {
+        const double* const x = reinterpret_cast<const double*>(pt);
+        maxCoord = fmax(maxCoord, fmax(fabs(x[0]), fmax(fabs(x[1]), fabs(x[2]))));
+        for (int32_t a = 0; a < g_nFilterAxes; ++a) {
+            const double proj = g_filterAxes[a][0] * x[0] + g_filterAxes[a][1] * x[1] + g_filterAxes[a][2] * x[2];
+            if (proj < minProj[a]) {
+                minProj[a] = proj;
+                minIndex[a] = p;
+            }
+            if (proj > maxProj[a]) {
+                maxProj[a] = proj;
+                maxIndex[a] = p;
+            }
+        }
+    }
+    m_extremePoints.resize(0);
+    for (int32_t a = 0; a < 2 * g_nFilterAxes; ++a) {
+        const int32_t p = (a < g_nFilterAxes) ? minIndex[a] : maxIndex[a - g_nFilterAxes];
+        const double* const x = reinterpret_cast<const double*>(reinterpret_cast<const char*>(points) + static_cast<size_t>(p) * stride);
+        m_extremePoints.push_back(x[0]);
+        m_extremePoints.push_back(x[1]);
+        m_extremePoints.push_back(x[2]);
+    }
+    // a flat or uncertain polytope has no interior
+    if (!m_polytope.Compute(&m_extremePoints[0], 3 * sizeof(double), 2 * g_nFilterAxes)) {
+        return false;
+    }
+    // the first three axes are the coordinate axes
+    double step[3];
+    for (int32_t k = 0; k < 3; ++k) {
+        step[k] = (maxProj[k] - minProj[k]) / g_quantizationSteps + g_btScalarRoundoff * maxCoord;
+    }
+    const int32_t nFaces = m_polytope.GetNFaces();
+    m_planes.resize(4 * nFaces);
+    for (int32_t t = 0; t < nFaces; ++t) {
+        const int32_t* const face = m_polytope.GetFace(t);
+        const double* const a = &m_extremePoints[3 * m_polytope.GetVertex(face[0])];
+        const double* const b = &m_extremePoints[3 * m_polytope.GetVertex(face[1])];
+        const double* const c = &m_extremePoints[3 * m_polytope.GetVertex(face[2])];
+        const double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const double v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        double* const plane = &m_planes[4 * t];
+        plane[0] = u[1] * v[2] - u[2] * v[1];
+        plane[1] = u[2] * v[0] - u[0] * v[2];
+        plane[2] = u[0] * v[1] - u[1] * v[0];
+        const double tolerance = g_filterTolerance * (fabs(plane[0]) + fabs(plane[1]) + fabs(plane[2])) * maxCoord;
+        // the point must stay inside once it and the polytope are snapped to the grid, that is the box of twice the
+        // grid step around it must be inside
+        const double snapping = 2.0 * (fabs(plane[0]) * step[0] + fabs(plane[1]) * step[1] + fabs(plane[2]) * step[2]);
+        plane[3] = plane[0] * a[0] + plane[1] * a[1] + plane[2] * a[2] - tolerance - snapping;
+    }
+    // keep the points that are not strictly inside all the faces
+    double x[g_filterBlockSize];
+    double y[g_filterBlockSize];
+    double z[g_filterBlockSize];
+    int32_t inside[g_filterBlockSize];
+    pt = reinterpret_cast<const char*>(points);
+    for (int32_t p0 = 0; p0 < nPoints; p0 += g_filterBlockSize) {
+        const int32_t nb = (nPoints - p0 < g_filterBlockSize) ? nPoints - p0 : g_filterBlockSize;
+        for (int32_t i = 0; i < nb; ++i, pt += stride) {
+            const double* const q = reinterpret_cast<const double*>(pt);
+            x[i] = q[0];
+            y[i] = q[1];
+            z[i] = q[2];
+            inside[i] = 1;
+        }
+        for (int32_t t = 0; t < nFaces; ++t) {
+            const double* const plane = &m_planes[4 * t];
+            const double nx = plane[0];
+            const double ny = plane[1];
+            const double nz = plane[2];
+            const double d = plane[3];
+            for (int32_t i = 0; i < nb; ++i) {
+                inside[i] &= (nx * x[i] + ny * y[i] + nz * z[i] < d) ? 1 : 0;
+            }
+        }
+        for (int32_t i = 0; i < nb; ++i) {
+            if (!inside[i]) {
+                m_points.push_back(x[i]);
+                m_points.push_back(y[i]);
+                m_points.push_back(z[i]);
+            }
+        }
+    }
+    const int32_t nRejected = nPoints - GetNPoints();
+    m_nRejectedPoints += nRejected;
+    return nRejected > 0;
+}
+}
@@ -0,0 +1,732 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vhacdIndexedICHull.h"
+#include <algorithm>
+#include <limits>
+
+namespace VHACD {
+// Relative rounding error bound of ComputeVolume4(), generous since the differences to the fourth point are rounded too
+static const double g_volumeErrorBound = 32.0 * 1.1102230246251565e-16;
+// Relative rounding error bound of an addition (twice the unit roundoff, for margin)
+static const double g_sumErrorBound = 2.0 * 1.1102230246251565e-16;
+
+const double IndexedICHull::sc_eps = 1.0e-15;
+const int32_t IndexedICHull::sc_dummyIndex = std::numeric_limits<int32_t>::max();
+IndexedICHull::IndexedICHull()
+{
+    m_isFlat = false;
+    m_freeConflicts = -1;
+}
+bool IndexedICHull::AddPoints(const Vec3<double>* points, size_t nPoints)
+{
+    if (!points) {
+        return false;
+    }
+    for (size_t i = 0; i < nPoints; i++) {
+        Vertex& vertex = m_vertices[m_vertices.Add()];
+        vertex.m_pos = points[i];
+        vertex.m_name = static_cast<int32_t>(i);
+    }
+    return true;
+}
+ICHullError IndexedICHull::Process(const uint32_t nPointsCH,
+    const double minVolume)
+{
+    uint32_t addedPoints = 0;
+    if (nPointsCH < 3 || m_vertices.GetSize() < 3) {
+        return ICHullErrorNotEnoughPoints;
+    }
+    if (m_vertices.GetSize() == 3) {
+        m_isFlat = true;
+        const int32_t t1 = m_triangles.Add();
+        const int32_t t2 = m_triangles.Add();
+        const int32_t v0 = m_vertices.GetHead();
+        const int32_t v1 = m_vertices.GetNext(v0);
+        const int32_t v2 = m_vertices.GetNext(v1);
+        // Compute the normal to the plane
+        m_normal = (GetPos(v1) - GetPos(v0)) ^ (GetPos(v2) - GetPos(v0));
+        m_normal.Normalize();
+        m_triangles[t1].m_vertices[0] = v0;
+        m_triangles[t1].m_vertices[1] = v1;
+        m_triangles[t1].m_vertices[2] = v2;
+        m_triangles[t2].m_vertices[0] = v1;
+        m_triangles[t2].m_vertices[1] = v0;
+        m_triangles[t2].m_vertices[2] = v2;
+        return ICHullErrorOK;
+    }
+
+    if (m_isFlat) {
+        m_triangles.Clear();
+        m_edges.Clear();
+        m_isFlat = false;
+    }
+
+    if (m_triangles.GetSize() == 0) // we have to create the first polyhedron
+    {
+        ICHullError res = DoubleTriangle();
+        if (res != ICHullErrorOK) {
+            return res;
+        }
+        else {
+            addedPoints += 3;
+        }
+    }
+    InitConflicts();
+    while (!m_vertices.GetData().m_tag && addedPoints < nPointsCH) // not processed
+    {
+        if (!FindMaxVolumePoint((addedPoints > 4) ? minVolume : 0.0)) {
+            break;
+        }
+        m_vertices.GetData().m_tag = true;
+        if (ProcessPoint()) {
+            UpdateConflicts();
+            addedPoints++;
+            CleanUp(addedPoints);
+            if (!CheckConsistancy()) {
+                size_t nV = m_vertices.GetSize();
+                for (size_t v = 0; v < nV; ++v) {
+                    if (m_vertices.GetData().m_name == sc_dummyIndex) {
+                        m_vertices.Delete();
+                        break;
+                    }
+                    m_vertices.Next();
+                }
+                return ICHullErrorInconsistent;
+            }
+            m_vertices.Next();
+        }
+    }
+    // delete remaining points
+    while (!m_vertices.GetData().m_tag) {
+        m_vertices.Delete();
+    }
+    if (m_isFlat) {
+        m_trianglesToDuplicate.Resize(0);
+        size_t nT = m_triangles.GetSize();
+        for (size_t f = 0; f < nT; f++) {
+            const int32_t head = m_triangles.GetHead();
+            const Triangle& currentTriangle = m_triangles[head];
+            if (m_vertices[currentTriangle.m_vertices[0]].m_name == sc_dummyIndex || m_vertices[currentTriangle.m_vertices[1]].m_name == sc_dummyIndex || m_vertices[currentTriangle.m_vertices[2]].m_name == sc_dummyIndex) {
+                m_trianglesToDelete.PushBack(head);
+                for (int32_t k = 0; k < 3; k++) {
+                    for (int32_t h = 0; h < 2; h++) {
+                        if (m_edges[currentTriangle.m_edges[k]].m_triangles[h] == head) {
+                            m_edges[currentTriangle.m_edges[k]].m_triangles[h] = -1;
+                            break;
+                        }
+                    }
+                }
+            }
+            else {
+                m_trianglesToDuplicate.PushBack(head);
+            }
+            m_triangles.Next();
+        }
+        size_t nE = m_edges.GetSize();
+        for (size_t e = 0; e < nE; e++) {
+            const Edge& currentEdge = m_edges.GetData();
+            if (currentEdge.m_triangles[0] < 0 && currentEdge.m_triangles[1] < 0) {
+                m_edgesToDelete.PushBack(m_edges.GetHead());
+            }
+            m_edges.Next();
+        }
+        size_t nV = m_vertices.GetSize();
+        for (size_t v = 0; v < nV; ++v) {
+            if (m_vertices.GetData().m_name == sc_dummyIndex) {
+                m_vertices.Delete();
+            }
+            else {
+                m_vertices.GetData().m_tag = false;
+                m_vertices.Next();
+            }
+        }
+        CleanEdges();
+        CleanTriangles();
+        for (size_t t = 0; t < m_trianglesToDuplicate.Size(); t++) {
+            const int32_t newTriangle = m_triangles.Add();
+            const int32_t duplicated = m_trianglesToDuplicate[t];
+            m_triangles[newTriangle].m_vertices[0] = m_triangles[duplicated].m_vertices[1];
+            m_triangles[newTriangle].m_vertices[1] = m_triangles[duplicated].m_vertices[0];
+            m_triangles[newTriangle].m_vertices[2] = m_triangles[duplicated].m_vertices[2];
+        }
+    }
+    return ICHullErrorOK;
+}
+double IndexedICHull::ComputePointVolume(const int32_t v) const
+{
+    // volume seen by the vertex, summed over the triangles in list order as ICHull does
+    double totalVolume = 0.0;
+    const int32_t fHead = m_triangles.GetHead();
+    int32_t f = fHead;
+    do {
+        const Triangle& triangle = m_triangles[f];
+        const double vol = ComputeVolume4(GetPos(triangle.m_vertices[0]), GetPos(triangle.m_vertices[1]), GetPos(triangle.m_vertices[2]), GetPos(v));
+        if (vol < -sc_eps) {
+            totalVolume += fabs(vol);
+        }
+        f = m_triangles.GetNext(f);
+    } while (f != fHead);
+    return totalVolume;
+}
+bool IndexedICHull::FindMaxVolumePoint(const double minVolume)
+{
+    // The incremental volumes differ from the sums over the triangles by their rounding errors: the largest lower bound
+    // of the volumes is found first, and the points that may reach it are compared with their summed volumes
+    const int32_t vHead = m_vertices.GetHead();
+    double maxLowerVolume = minVolume;
+    for (int32_t v = vHead; !m_vertices[v].m_tag; v = m_vertices.GetNext(v)) // not processed
+    {
+        const int32_t point = m_vertices[v].m_point;
+        maxLowerVolume = std::max(maxLowerVolume, m_pointVolumes[point] - m_pointVolumeErrors[point]);
+    }
+    int32_t vMaxVolume = -1;
+    double maxVolume = minVolume;
+    for (int32_t v = vHead; !m_vertices[v].m_tag; v = m_vertices.GetNext(v)) // not processed
+    {
+        const int32_t point = m_vertices[v].m_point;
+        const double upperVolume = m_pointVolumes[point] + m_pointVolumeErrors[point];
+        if (upperVolume > minVolume && upperVolume >= maxLowerVolume) {
+            const double volume = ComputePointVolume(v);
+            if (maxVolume < volume) {
+                maxVolume = volume;
+                vMaxVolume = v;
+            }
+        }
+    }
+    if (vMaxVolume < 0) {
+        return false;
+    }
+    if (vMaxVolume != vHead) {
+        // neither vertex is on the hull yet, so they can be exchanged with their conflict data
+        Vertex temp = m_vertices[vHead];
+        m_vertices[vHead] = m_vertices[vMaxVolume];
+        m_vertices[vMaxVolume] = temp;
+        m_pointVertices[m_vertices[vHead].m_point] = vHead;
+        m_pointVertices[m_vertices[vMaxVolume].m_point] = vMaxVolume;
+    }
+    return true;
+}
+bool IndexedICHull::AddConflict(const int32_t f, const int32_t point)
+{
+    // Adds the point to the conflict list of the triangle if it sees it, and returns false if its side of the triangle
+    // is not certain (volume within the tolerance or the rounding error)
+    const Triangle& triangle = m_triangles[f];
+    const Vec3<double>& d = GetPos(m_pointVertices[point]);
+    const Vec3<double> ad = GetPos(triangle.m_vertices[0]) - d;
+    const Vec3<double> bd = GetPos(triangle.m_vertices[1]) - d;
+    const Vec3<double> cd = GetPos(triangle.m_vertices[2]) - d;
+    const double vol = ad * (bd ^ cd);
+    if (vol < -sc_eps) {
+        int32_t c = m_freeConflicts;
+        if (c < 0) {
+            c = static_cast<int32_t>(m_conflicts.Size());
+            Conflict conflict;
+            m_conflicts.PushBack(conflict);
+        }
+        else {
+            m_freeConflicts = m_conflicts[c].m_next;
+        }
+        Conflict& conflict = m_conflicts[c];
+        conflict.m_volume = fabs(vol);
+        conflict.m_point = point;
+        conflict.m_next = triangle.m_conflicts;
+        m_triangles[f].m_conflicts = c;
+        m_pointVolumes[point] += conflict.m_volume;
+        m_pointNConflicts[point]++;
+        // error of the addition, and of the sum of the conflict volumes in another order
+        m_pointVolumeErrors[point] += g_sumErrorBound * (m_pointNConflicts[point] + 1) * m_pointVolumes[point];
+    }
+    if (fabs(vol) <= sc_eps) {
+        return false;
+    }
+    const double permanent = fabs(ad[0]) * (fabs(bd[1] * cd[2]) + fabs(bd[2] * cd[1]))
+        + fabs(ad[1]) * (fabs(bd[2] * cd[0]) + fabs(bd[0] * cd[2]))
+        + fabs(ad[2]) * (fabs(bd[0] * cd[1]) + fabs(bd[1] * cd[0]));
+    return fabs(vol) > g_volumeErrorBound * permanent;
+}
+void IndexedICHull::AddUncertainPoint(const int32_t point)
+{
+    if (!m_pointUncertain[point]) {
+        m_pointUncertain[point] = 1;
+        m_uncertainPoints.PushBack(point);
+    }
+}
+void IndexedICHull::InitConflicts()
+{
+    m_conflicts.Resize(0);
+    m_freeConflicts = -1;
+    m_uncertainPoints.Resize(0);
+    const size_t nPoints = m_vertices.GetCapacity();
+    m_pointVertices.Resize(nPoints);
+    m_pointUncertain.Resize(nPoints);
+    m_pointVolumes.Resize(nPoints);
+    m_pointVolumeErrors.Resize(nPoints);
+    m_pointNConflicts.Resize(nPoints);
+    m_pointStamps.Resize(nPoints);
+    m_stamp = 0;
+    const int32_t fHead = m_triangles.GetHead();
+    int32_t f = fHead;
+    do {
+        m_triangles[f].m_conflicts = -1;
+        f = m_triangles.GetNext(f);
+    } while (f != fHead);
+    // the point of a vertex is its initial index, and the triangles are visited in list order, as ICHull does when
+    // summing the volume seen by a point
+    for (int32_t v = m_vertices.GetHead(); !m_vertices[v].m_tag; v = m_vertices.GetNext(v)) {
+        m_vertices[v].m_point = v;
+        m_pointVertices[v] = v;
+        m_pointVolumes[v] = 0.0;
+        m_pointVolumeErrors[v] = 0.0;
+        m_pointNConflicts[v] = 0;
+        m_pointStamps[v] = 0;
+        m_pointUncertain[v] = 0;
+        bool certain = true;
+        f = fHead;
+        do {
+            certain = AddConflict(f, v) && certain;
+            f = m_triangles.GetNext(f);
+        } while (f != fHead);
+        // the first polyhedron may be flat (two back-to-back triangles), and the points of its plane see none of its
+        // triangles even if they lie outside of it
+        if (!certain || m_pointNConflicts[v] == 0) {
+            AddUncertainPoint(v);
+        }
+    }
+}
+void IndexedICHull::UpdateConflicts()
+{
+    // a point that sees the new triangle of a horizon edge sees one of the two triangles adjacent to the edge (the
+    // replaced one or the kept one), so only their conflict lists are checked, along with the uncertain points
+    const size_t ne_update = m_edgesToUpdate.Size();
+    for (size_t i = 0; i < ne_update; ++i) {
+        const Edge& edge = m_edges[m_edgesToUpdate[i]];
+        const int32_t newFace = edge.m_newFace;
+        ++m_stamp;
+        for (int32_t k = 0; k < 2; ++k) {
+            for (int32_t c = m_triangles[edge.m_triangles[k]].m_conflicts; c >= 0; c = m_conflicts[c].m_next) {
+                const int32_t point = m_conflicts[c].m_point;
+                if (m_pointStamps[point] != m_stamp && !m_vertices[m_pointVertices[point]].m_tag) {
+                    m_pointStamps[point] = m_stamp;
+                    if (!AddConflict(newFace, point)) {
+                        AddUncertainPoint(point);
+                    }
+                }
+            }
+        }
+        for (size_t p = 0; p < m_uncertainPoints.Size(); ++p) {
+            const int32_t point = m_uncertainPoints[p];
+            if (m_pointStamps[point] != m_stamp && !m_vertices[m_pointVertices[point]].m_tag) {
+                m_pointStamps[point] = m_stamp;
+                AddConflict(newFace, point);
+            }
+        }
+    }
+    // the processed points are removed from the uncertain points
+    size_t nUncertainPoints = 0;
+    for (size_t p = 0; p < m_uncertainPoints.Size(); ++p) {
+        const int32_t point = m_uncertainPoints[p];
+        if (!m_vertices[m_pointVertices[point]].m_tag) {
+            m_uncertainPoints[nUncertainPoints++] = point;
+        }
+    }
+    m_uncertainPoints.Resize(nUncertainPoints);
+    // release the conflict lists of the triangles seen by the new vertex
+    const size_t nt_delete = m_trianglesToDelete.Size();
+    for (size_t i = 0; i < nt_delete; ++i) {
+        Triangle& triangle = m_triangles[m_trianglesToDelete[i]];
+        int32_t c = triangle.m_conflicts;
+        while (c >= 0) {
+            Conflict& conflict = m_conflicts[c];
+            const int32_t point = conflict.m_point;
+            if (--m_pointNConflicts[point] == 0) {
+                m_pointVolumes[point] = 0.0;
+                m_pointVolumeErrors[point] = 0.0;
+            }
+            else {
+                // the subtraction is exact up to the volume before it
+                m_pointVolumeErrors[point] += g_sumErrorBound * (m_pointNConflicts[point] + 1) * m_pointVolumes[point];
+                m_pointVolumes[point] -= conflict.m_volume;
+            }
+            const int32_t next = conflict.m_next;
+            conflict.m_next = m_freeConflicts;
+            m_freeConflicts = c;
+            c = next;
+        }
+        triangle.m_conflicts = -1;
+    }
+}
+ICHullError IndexedICHull::DoubleTriangle()
+{
+    // find three non colinear points
+    m_isFlat = false;
+    const int32_t head = m_vertices.GetHead();
+    int32_t v0 = head;
+    while (Colinear(GetPos(v0),
+        GetPos(m_vertices.GetNext(v0)),
+        GetPos(m_vertices.GetNext(m_vertices.GetNext(v0))))) {
+        if ((v0 = m_vertices.GetNext(v0)) == head) {
+            return ICHullErrorCoplanarPoints;
+        }
+    }
+    const int32_t v1 = m_vertices.GetNext(v0);
+    const int32_t v2 = m_vertices.GetNext(v1);
+    // mark points as processed
+    m_vertices[v0].m_tag = m_vertices[v1].m_tag = m_vertices[v2].m_tag = true;
+
+    // create two triangles
+    const int32_t f0 = MakeFace(v0, v1, v2, -1);
+    MakeFace(v2, v1, v0, f0);
+
+    // find a fourth non-coplanar point to form tetrahedron
+    int32_t v3 = m_vertices.GetNext(v2);
+    m_vertices.GetHead() = v3;
+
+    double vol = ComputeVolume4(GetPos(v0), GetPos(v1), GetPos(v2), GetPos(v3));
+    while (fabs(vol) < sc_eps && !m_vertices[m_vertices.GetNext(v3)].m_tag) {
+        v3 = m_vertices.GetNext(v3);
+        vol = ComputeVolume4(GetPos(v0), GetPos(v1), GetPos(v2), GetPos(v3));
+    }
+    if (fabs(vol) < sc_eps) {
+        // compute the barycenter
+        Vec3<double> bary(0.0, 0.0, 0.0);
+        int32_t vBary = v0;
+        do {
+            bary += GetPos(vBary);
+        } while ((vBary = m_vertices.GetNext(vBary)) != v0);
+        bary /= static_cast<double>(m_vertices.GetSize());
+
+        // Compute the normal to the plane
+        m_normal = (GetPos(v1) - GetPos(v0)) ^ (GetPos(v2) - GetPos(v0));
+        m_normal.Normalize();
+        // add dummy vertex placed at (bary + normal)
+        m_vertices.GetHead() = v2;
+        const Vec3<double> newPt = bary + m_normal;
+        Vertex& dummy = m_vertices[m_vertices.Add()];
+        dummy.m_pos = newPt;
+        dummy.m_name = sc_dummyIndex;
+        m_isFlat = true;
+        return ICHullErrorOK;
+    }
+    else if (v3 != m_vertices.GetHead()) {
+        Vertex& first = m_vertices.GetData();
+        Vertex temp;
+        temp.m_name = m_vertices[v3].m_name;
+        temp.m_pos = m_vertices[v3].m_pos;
+        m_vertices[v3].m_name = first.m_name;
+        m_vertices[v3].m_pos = first.m_pos;
+        first.m_name = temp.m_name;
+        first.m_pos = temp.m_pos;
+    }
+    return ICHullErrorOK;
+}
+int32_t IndexedICHull::MakeFace(const int32_t v0,
+    const int32_t v1,
+    const int32_t v2,
+    const int32_t fold)
+{
+    int32_t e0;
+    int32_t e1;
+    int32_t e2;
+    int32_t index = 0;
+    if (fold < 0) // if first face to be created
+    {
+        e0 = m_edges.Add(); // create the three edges
+        e1 = m_edges.Add();
+        e2 = m_edges.Add();
+    }
+    else // otherwise re-use existing edges (in reverse order)
+    {
+        e0 = m_triangles[fold].m_edges[2];
+        e1 = m_triangles[fold].m_edges[1];
+        e2 = m_triangles[fold].m_edges[0];
+        index = 1;
+    }
+    m_edges[e0].m_vertices[0] = v0;
+    m_edges[e0].m_vertices[1] = v1;
+    m_edges[e1].m_vertices[0] = v1;
+    m_edges[e1].m_vertices[1] = v2;
+    m_edges[e2].m_vertices[0] = v2;
+    m_edges[e2].m_vertices[1] = v0;
+    // create the new face
+    const int32_t f = m_triangles.Add();
+    Triangle& face = m_triangles[f];
+    face.m_edges[0] = e0;
+    face.m_edges[1] = e1;
+    face.m_edges[2] = e2;
+    face.m_vertices[0] = v0;
+    face.m_vertices[1] = v1;
+    face.m_vertices[2] = v2;
+    // link edges to face f
+    m_edges[e0].m_triangles[index] = m_edges[e1].m_triangles[index] = m_edges[e2].m_triangles[index] = f;
+    return f;
+}
+int32_t IndexedICHull::MakeConeFace(const int32_t e, const int32_t p)
+{
+    // create two new edges if they don't already exist
+    int32_t newEdges[2];
+    for (int32_t i = 0; i < 2; ++i) {
+        const int32_t v = m_edges[e].m_vertices[i];
+        if ((newEdges[i] = m_vertices[v].m_duplicate) < 0) { // if the edge doesn't exits add it and mark the vertex as duplicated
+            newEdges[i] = m_edges.Add();
+            m_edges[newEdges[i]].m_vertices[0] = v;
+            m_edges[newEdges[i]].m_vertices[1] = p;
+            m_vertices[v].m_duplicate = newEdges[i];
+        }
+    }
+    // make the new face
+    const int32_t newFace = m_triangles.Add();
+    m_triangles[newFace].m_edges[0] = e;
+    m_triangles[newFace].m_edges[1] = newEdges[0];
+    m_triangles[newFace].m_edges[2] = newEdges[1];
+    MakeCCW(newFace, e, p);
+    for (int32_t i = 0; i < 2; ++i) {
+        for (int32_t j = 0; j < 2; ++j) {
+            if (m_edges[newEdges[i]].m_triangles[j] < 0) {
+                m_edges[newEdges[i]].m_triangles[j] = newFace;
+                break;
+            }
+        }
+    }
+    return newFace;
+}
+bool IndexedICHull::MarkVisibleFaces()
+{
+    // mark the faces visible from the head vertex
+    const int32_t fHead = m_triangles.GetHead();
+    int32_t f = fHead;
+    const Vec3<double> pos0 = GetPos(m_vertices.GetHead());
+    bool visible = false;
+    do {
+        const Triangle& triangle = m_triangles[f];
+        const double vol = ComputeVolume4(GetPos(triangle.m_vertices[0]), GetPos(triangle.m_vertices[1]), GetPos(triangle.m_vertices[2]), pos0);
+        if (vol < -sc_eps) {
+            m_triangles[f].m_visible = true;
+            m_trianglesToDelete.PushBack(f);
+            visible = true;
+        }
+        f = m_triangles.GetNext(f);
+    } while (f != fHead);
+
+    if (m_trianglesToDelete.Size() == m_triangles.GetSize()) {
+        for (size_t i = 0; i < m_trianglesToDelete.Size(); i++) {
+            m_triangles[m_trianglesToDelete[i]].m_visible = false;
+        }
+        visible = false;
+    }
+    // if no faces visible from p then p is inside the hull
+    if (!visible) {
+        m_vertices.Delete();
+        m_trianglesToDelete.Resize(0);
+        return false;
+    }
+    return true;
+}
+bool IndexedICHull::ProcessPoint()
+{
+    if (!MarkVisibleFaces()) {
+        return false;
+    }
+    // Mark edges in interior of visible region for deletion.
+    // Create a new face based on each border edge
+    const int32_t v0 = m_vertices.GetHead();
+    const int32_t eHead = m_edges.GetHead();
+    int32_t e = eHead;
+    m_edgesToDelete.Resize(0);
+    m_edgesToUpdate.Resize(0);
+    do {
+        const int32_t tmp = m_edges.GetNext(e);
+        int32_t nvisible = 0;
+        for (int32_t k = 0; k < 2; k++) {
+            if (m_triangles[m_edges[e].m_triangles[k]].m_visible) {
+                nvisible++;
+            }
+        }
+        if (nvisible == 2) {
+            m_edgesToDelete.PushBack(e);
+        }
+        else if (nvisible == 1) {
+            const int32_t newFace = MakeConeFace(e, v0);
+            m_edges[e].m_newFace = newFace;
+            m_edgesToUpdate.PushBack(e);
+        }
+        e = tmp;
+    } while (e != eHead);
+    return true;
+}
+bool IndexedICHull::MakeCCW(const int32_t f,
+    const int32_t e,
+    const int32_t v)
+{
+    // the visible face adjacent to e
+    const Edge& edge = m_edges[e];
+    const int32_t fv = m_triangles[edge.m_triangles[0]].m_visible ? edge.m_triangles[0] : edge.m_triangles[1];
+
+    //  set vertex[0] and vertex[1] to have the same orientation as the corresponding vertices of fv.
+    int32_t i; // index of e->m_vertices[0] in fv
+    const int32_t v0 = edge.m_vertices[0];
+    const int32_t v1 = edge.m_vertices[1];
+    const Triangle& visibleFace = m_triangles[fv];
+    for (i = 0; visibleFace.m_vertices[i] != v0; i++)
+        ;
+
+    Triangle& face = m_triangles[f];
+    if (visibleFace.m_vertices[(i + 1) % 3] != v1) {
+        face.m_vertices[0] = v1;
+        face.m_vertices[1] = v0;
+    }
+    else {
+        face.m_vertices[0] = v0;
+        face.m_vertices[1] = v1;
+        // swap edges
+        const int32_t tmp = face.m_edges[0];
+        face.m_edges[0] = face.m_edges[1];
+        face.m_edges[1] = tmp;
+    }
+    face.m_vertices[2] = v;
+    return true;
+}
+bool IndexedICHull::CleanUp(uint32_t& addedPoints)
+{
+    bool r0 = CleanEdges();
+    bool r1 = CleanTriangles();
+    bool r2 = CleanVertices(addedPoints);
+    return r0 && r1 && r2;
+}
+bool IndexedICHull::CleanEdges()
+{
+    // integrate the new faces into the data structure
+    const size_t ne_update = m_edgesToUpdate.Size();
+    for (size_t i = 0; i < ne_update; ++i) {
+        Edge& edge = m_edges[m_edgesToUpdate[i]];
+        if (edge.m_newFace >= 0) {
+            if (m_triangles[edge.m_triangles[0]].m_visible) {
+                edge.m_triangles[0] = edge.m_newFace;
+            }
+            else {
+                edge.m_triangles[1] = edge.m_newFace;
+            }
+            edge.m_newFace = -1;
+        }
+    }
+    // delete edges maked for deletion
+    const size_t ne_delete = m_edgesToDelete.Size();
+    for (size_t i = 0; i < ne_delete; ++i) {
+        m_edges.Delete(m_edgesToDelete[i]);
+    }
+    m_edgesToDelete.Resize(0);
+    m_edgesToUpdate.Resize(0);
+    return true;
+}
+bool IndexedICHull::CleanTriangles()
+{
+    const size_t nt_delete = m_trianglesToDelete.Size();
+    for (size_t i = 0; i < nt_delete; ++i) {
+        m_triangles.Delete(m_trianglesToDelete[i]);
+    }
+    m_trianglesToDelete.Resize(0);
+    return true;
+}
+bool IndexedICHull::CleanVertices(uint32_t& addedPoints)
+{
+    // mark all vertices incident to some undeleted edge as on the hull
+    int32_t e = m_edges.GetHead();
+    size_t nE = m_edges.GetSize();
+    for (size_t i = 0; i < nE; i++) {
+        m_vertices[m_edges[e].m_vertices[0]].m_onHull = true;
+        m_vertices[m_edges[e].m_vertices[1]].m_onHull = true;
+        e = m_edges.GetNext(e);
+    }
+    // delete all the vertices that have been processed but are not on the hull
+    const int32_t vHead = m_vertices.GetHead();
+    int32_t v = m_vertices.GetPrev(vHead);
+    do {
+        if (m_vertices[v].m_tag && !m_vertices[v].m_onHull) {
+            const int32_t tmp = m_vertices.GetPrev(v);
+            m_vertices.Delete(v);
+            v = tmp;
+            addedPoints--;
+        }
+        else {
+            m_vertices[v].m_duplicate = -1;
+            m_vertices[v].m_onHull = false;
+            v = m_vertices.GetPrev(v);
+        }
+    } while (m_vertices[v].m_tag && v != vHead);
+    return true;
+}
+bool IndexedICHull::CheckConsistancy()
+{
+    // walks the lists by moving their heads, as TMMesh::CheckConsistancy does, so an inconsistent hull is left in
+    // the same state
+    size_t nE = m_edges.GetSize();
+    size_t nT = m_triangles.GetSize();
+    for (size_t e = 0; e < nE; e++) {
+        for (int32_t f = 0; f < 2; f++) {
+            if (m_edges.GetData().m_triangles[f] < 0) {
+                return false;
+            }
+        }
+        m_edges.Next();
+    }
+    for (size_t f = 0; f < nT; f++) {
+        const int32_t head = m_triangles.GetHead();
+        for (int32_t e = 0; e < 3; e++) {
+            int32_t found = 0;
+            for (int32_t k = 0; k < 2; k++) {
+                if (m_edges[m_triangles[head].m_edges[e]].m_triangles[k] == head) {
+                    found++;
+                }
+            }
+            if (found != 1) {
+                return false;
+            }
+        }
+        m_triangles.Next();
+    }
+    return true;
+}
+void IndexedICHull::GetIFS(Vec3<double>* const points, Vec3<int32_t>* const triangles)
+{
+    const size_t nV = m_vertices.GetSize();
+    const size_t nT = m_triangles.GetSize();
+    int32_t v = m_vertices.GetHead();
+    for (size_t i = 0; i < nV; i++) {
+        points[i] = m_vertices[v].m_pos;
+        m_vertices[v].m_id = static_cast<int32_t>(i);
+        v = m_vertices.GetNext(v);
+    }
+    int32_t f = m_triangles.GetHead();
+    for (size_t i = 0; i < nT; i++) {
+        const Triangle& currentTriangle = m_triangles[f];
+        triangles[i].X() = m_vertices[currentTriangle.m_vertices[0]].m_id;
+        triangles[i].Y() = m_vertices[currentTriangle.m_vertices[1]].m_id;
+        triangles[i].Z() = m_vertices[currentTriangle.m_vertices[2]].m_id;
+        f = m_triangles.GetNext(f);
+    }
+}
+void IndexedICHull::Clear()
+{
+    m_vertices.Clear();
+    m_edges.Clear();
+    m_triangles.Clear();
+    m_edgesToDelete.Resize(0);
+    m_edgesToUpdate.Resize(0);
+    m_trianglesToDelete.Resize(0);
+    m_conflicts.Resize(0);
+    m_freeConflicts = -1;
+    m_uncertainPoints.Resize(0);
+    m_isFlat = false;
+}
+}
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <utility>
 
 namespace VHACD {
 Mesh::Mesh()
@@ -36,6 +37,75 @@ Mesh::~Mesh()
 {
 }
 
+ConvexHullMesh::ConvexHullMesh(const Mesh& mesh)
+    : m_mesh(mesh)
+{
+    Init();
+}
+ConvexHullMesh::ConvexHullMesh(Mesh&& mesh)
+    : m_mesh(std::move(mesh))
+{
+    Init();
+}
+void ConvexHullMesh::Init()
+{
+    m_volume = m_mesh.ComputeVolume();
+    if (m_mesh.GetNPoints() == 0) {
+        m_minBB = Vec3<double>(0.0);
+        m_maxBB = Vec3<double>(0.0);
+        m_center = Vec3<double>(0.0);
+        return;
+    }
+    // centroid and bounding box
+    m_center = m_mesh.ComputeCenter();
+    m_minBB = m_mesh.GetMinBB();
+    m_maxBB = m_mesh.GetMaxBB();
+    const size_t nT = m_mesh.GetNTriangles();
+    m_planes.Reserve(nT);
+    Plane plane;
+    plane.m_axis = AXIS_X;
+    plane.m_index = -1;
+    for (size_t t = 0; t < nT; ++t) {
+        const Vec3<int32_t>& tri = m_mesh.GetTriangle(t);
+        const Vec3<double>& ver0 = m_mesh.GetPoint(tri[0]);
+        Vec3<double> normal = (m_mesh.GetPoint(tri[1]) - ver0) ^ (m_mesh.GetPoint(tri[2]) - ver0);
+        const double norm = normal.GetNorm();
+        if (norm > 0.0) {
+            normal /= -norm;
+            plane.m_a = normal[0];
+            plane.m_b = normal[1];
+            plane.m_c = normal[2];
+            plane.m_d = -(normal * ver0);
+            m_planes.PushBack(plane);
+        }
+    }
+}
+ConvexHullMesh::~ConvexHullMesh(void)
+{
+}
+void ConvexHullMesh::AddPointsOutside(const ConvexHullMesh& other, SArray<Vec3<double> >& pts) const
+{
+    const Array<Plane>& planes = other.GetPlanes();
+    const size_t nPlanes = planes.Size();
+    const Vec3<double>& minBB = other.GetMinBB();
+    const Vec3<double>& maxBB = other.GetMaxBB();
+    const double margin = MERGE_CULLING_TOLERANCE * (maxBB - minBB).GetNorm();
+    const size_t nPoints = GetNPoints();
+    for (size_t v = 0; v < nPoints; ++v) {
+        const Vec3<double>& pt = GetPoint(v);
+        bool inside = nPlanes > 0
+            && pt[0] > minBB[0] + margin && pt[0] < maxBB[0] - margin
+            && pt[1] > minBB[1] + margin && pt[1] < maxBB[1] - margin
+            && pt[2] > minBB[2] + margin && pt[2] < maxBB[2] - margin;
+        for (size_t t = 0; inside && t < nPlanes; ++t) {
+            const Plane& plane = planes[t];
+            inside = plane.m_a * pt[0] + plane.m_b * pt[1] + plane.m_c * pt[2] + plane.m_d > margin;
+        }
+        if (!inside) {
+            pts.PushBack(pt);
+        }
+    }
+}
 Vec3<double>& Mesh::ComputeCenter(void)
 {
 	const size_t nV = GetNPoints();
@@ -111,14 +181,17 @@ double Mesh::ComputeVolume() const
 }
 
 void Mesh::ComputeConvexHull(const double* const pts,
-    const size_t nPts)
+    const size_t nPts,
+    btConvexHullComputer* const hullComputer)
 {
-    ResizePoints(0);
     ResizeTriangles(0);
-    btConvexHullComputer ch;
+    btConvexHullComputer localHullComputer;
+    btConvexHullComputer& ch = (hullComputer) ? *hullComputer : localHullComputer;
     ch.compute(pts, 3 * sizeof(double), (int32_t)nPts, -1.0, -1.0);
-    for (int32_t v = 0; v < ch.vertices.size(); v++) {
-        AddPoint(Vec3<double>(ch.vertices[v].getX(), ch.vertices[v].getY(), ch.vertices[v].getZ()));
+    const int32_t nv = ch.vertices.size();
+    ResizePoints(nv);
+    for (int32_t v = 0; v < nv; v++) {
+        m_points[v] = Vec3<double>(ch.vertices[v].getX(), ch.vertices[v].getY(), ch.vertices[v].getZ());
     }
     const int32_t nt = ch.faces.size();
     for (int32_t t = 0; t < nt; ++t) {
@@ -0,0 +1,102 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vhacdPointWelder.h"
+#include <math.h>
+
+namespace VHACD {
+// Cells slightly larger than the weld distance, so that rounding can not put two points closer than the weld
+// distance more than one cell apart
+static const double g_weldCellScale = 1.001;
+// Cell coordinates are clamped, which only makes far away cells share buckets
+static const double g_maxWeldCell = 4.0e18;
+
+PointWelder::PointWelder()
+{
+    Reset(0.0);
+}
+void PointWelder::Reset(const double distance, const size_t expectedPoints)
+{
+    m_points.resize(0);
+    m_next.resize(0);
+    m_points.reserve(expectedPoints);
+    m_next.reserve(expectedPoints);
+    m_distance2 = distance * distance;
+    m_invCellSize = (distance > 0.0) ? 1.0 / (distance * g_weldCellScale) : 0.0;
+    size_t nBuckets = 64;
+    while (nBuckets < 2 * expectedPoints) {
+        nBuckets <<= 1;
+    }
+    m_buckets.assign(nBuckets, -1);
+}
+void PointWelder::GetCell(const Vec3<double>& pt, int64_t cell[3]) const
+{
+    for (int32_t k = 0; k < 3; ++k) {
+        double c = floor(pt[k] * m_invCellSize);
+        c = (c < -g_maxWeldCell) ? -g_maxWeldCell : ((c > g_maxWeldCell) ? g_maxWeldCell : c);
+        cell[k] = static_cast<int64_t>(c);
+    }
+}
+size_t PointWelder::GetBucket(const int64_t x, const int64_t y, const int64_t z) const
+{
+    const uint64_t h = (static_cast<uint64_t>(x) * 73856093ULL) ^ (static_cast<uint64_t>(y) * 19349663ULL) ^ (static_cast<uint64_t>(z) * 83492791ULL);
+    return static_cast<size_t>(h & (m_buckets.size() - 1));
+}
+void PointWelder::Rehash(const size_t nBuckets)
+{
+    m_buckets.assign(nBuckets, -1);
+    int64_t cell[3];
+    for (size_t i = 0; i < m_points.size(); ++i) {
+        GetCell(m_points[i], cell);
+        const size_t b = GetBucket(cell[0], cell[1], cell[2]);
+        m_next[i] = m_buckets[b];
+        m_buckets[b] = static_cast<int32_t>(i);
+    }
+}
+size_t PointWelder::Weld(const Vec3<double>& pt)
+{
+    int64_t cell[3];
+    if (m_distance2 > 0.0) {
+        GetCell(pt, cell);
+        // different cells may share a bucket, so the 27 buckets are searched in full: this is only redundant, the
+        // points being compared by distance
+        for (int64_t x = cell[0] - 1; x <= cell[0] + 1; ++x) {
+            for (int64_t y = cell[1] - 1; y <= cell[1] + 1; ++y) {
+                for (int64_t z = cell[2] - 1; z <= cell[2] + 1; ++z) {
+                    for (int32_t i = m_buckets[GetBucket(x, y, z)]; i >= 0; i = m_next[i]) {
+                        if (m_points[i].GetDistanceSquared(pt) < m_distance2) {
+                            return static_cast<size_t>(i);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    else {
+        cell[0] = cell[1] = cell[2] = 0;
+    }
+    const size_t index = m_points.size();
+    m_points.push_back(pt);
+    m_next.push_back(-1);
+    if (2 * m_points.size() > m_buckets.size()) {
+        Rehash(2 * m_buckets.size());
+    }
+    else {
+        const size_t b = GetBucket(cell[0], cell[1], cell[2]);
+        m_next[index] = m_buckets[b];
+        m_buckets[b] = static_cast<int32_t>(index);
+    }
+    return index;
+}
+}
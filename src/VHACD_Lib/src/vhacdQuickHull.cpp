@@ -0,0 +1,586 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vhacdQuickHull.h"
+#include <math.h>
+
+namespace VHACD {
+// Static error bound of the orient3d determinant for exact double inputs (Shewchuk): (7 + 56 eps) eps, eps = 2^-53
+static const double g_epsilon = 1.1102230246251565e-16;
+static const double g_orient3dErrorBound = (7.0 + 56.0 * g_epsilon) * g_epsilon;
+
+//! Returns a positive value if d is certainly above the plane of (a, b, c), counter-clockwise seen from above, a
+//! negative value if it is certainly below it, and 0 if the sign of the determinant can not be certified
+static inline double Orient(const double* const a, const double* const b, const double* const c, const double* const d)
+{
+    const double adx = a[0] - d[0];
+    const double bdx = b[0] - d[0];
+    const double cdx = c[0] - d[0];
+    const double ady = a[1] - d[1];
+    const double bdy = b[1] - d[1];
+    const double cdy = c[1] - d[1];
+    const double adz = a[2] - d[2];
+    const double bdz = b[2] - d[2];
+    const double cdz = c[2] - d[2];
+    const double bdxcdy = bdx * cdy;
+    const double cdxbdy = cdx * bdy;
+    const double cdxady = cdx * ady;
+    const double adxcdy = adx * cdy;
+    const double adxbdy = adx * bdy;
+    const double bdxady = bdx * ady;
+    const double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+    const double permanent = (fabs(bdxcdy) + fabs(cdxbdy)) * fabs(adz) + (fabs(cdxady) + fabs(adxcdy)) * fabs(bdz) + (fabs(adxbdy) + fabs(bdxady)) * fabs(cdz);
+    const double errorBound = g_orient3dErrorBound * permanent;
+    if (det > errorBound || -det > errorBound) {
+        return -det; // orient3d is positive below the plane
+    }
+    return 0.0;
+}
+//! Exact orientation of lattice points, whose coordinate extent is below 2^20 so that no product overflows: positive
+//! if d is above the plane of (a, b, c), counter-clockwise seen from above, negative below it, and 0 on it
+static inline int64_t LatticeOrient(const int32_t* const a, const int32_t* const b, const int32_t* const c, const int32_t* const d)
+{
+    const int64_t adx = a[0] - d[0];
+    const int64_t bdx = b[0] - d[0];
+    const int64_t cdx = c[0] - d[0];
+    const int64_t ady = a[1] - d[1];
+    const int64_t bdy = b[1] - d[1];
+    const int64_t cdy = c[1] - d[1];
+    const int64_t adz = a[2] - d[2];
+    const int64_t bdz = b[2] - d[2];
+    const int64_t cdz = c[2] - d[2];
+    return -(adz * (bdx * cdy - cdx * bdy) + bdz * (cdx * ady - adx * cdy) + cdz * (adx * bdy - bdx * ady));
+}
+
+QuickHull::QuickHull()
+{
+    m_points = 0;
+    m_latticePoints = 0;
+    m_stride = 0;
+    m_nPoints = 0;
+    m_stamp = 0;
+}
+void QuickHull::GetCoordinates(const int32_t p, double* const pt) const
+{
+    if (m_latticePoints) {
+        const int32_t* const lp = GetLatticePoint(p);
+        pt[0] = lp[0];
+        pt[1] = lp[1];
+        pt[2] = lp[2];
+    }
+    else {
+        const double* const dp = GetPoint(p);
+        pt[0] = dp[0];
+        pt[1] = dp[1];
+        pt[2] = dp[2];
+    }
+}
+double QuickHull::Side(const Face& face, const int32_t p) const
+{
+    if (m_latticePoints) {
+        return static_cast<double>(LatticeOrient(GetLatticePoint(face.m_vertices[0]), GetLatticePoint(face.m_vertices[1]),
+            GetLatticePoint(face.m_vertices[2]), GetLatticePoint(p)));
+    }
+    return Orient(GetPoint(face.m_vertices[0]), GetPoint(face.m_vertices[1]), GetPoint(face.m_vertices[2]), GetPoint(p));
+}
+int32_t QuickHull::AddFace(const int32_t v0, const int32_t v1, const int32_t v2)
+{
+    int32_t f;
+    if (m_freeFaces.empty()) {
+        f = static_cast<int32_t>(m_faces.size());
+        m_faces.push_back(Face());
+    }
+    else {
+        f = m_freeFaces.back();
+        m_freeFaces.pop_back();
+    }
+    Face& face = m_faces[f];
+    face.m_vertices[0] = v0;
+    face.m_vertices[1] = v1;
+    face.m_vertices[2] = v2;
+    face.m_adjacent[0] = face.m_adjacent[1] = face.m_adjacent[2] = -1;
+    face.m_outside = -1;
+    face.m_farthest = -1;
+    face.m_farthestDistance = 0.0;
+    face.m_stamp = 0;
+    face.m_visible = false;
+    face.m_alive = true;
+    return f;
+}
+void QuickHull::AddToOutside(const int32_t f, const int32_t p, const double distance)
+{
+    Face& face = m_faces[f];
+    m_nextOutside[p] = face.m_outside;
+    face.m_outside = p;
+    if (distance > face.m_farthestDistance) {
+        face.m_farthestDistance = distance;
+        face.m_farthest = p;
+    }
+}
+void QuickHull::AssignPoint(const int32_t p, const int32_t* const faces, const size_t nFaces)
+{
+    // a point that is not certainly above any of the faces is inside the hull, or within the rounding error of its
+    // surface
+    for (size_t i = 0; i < nFaces; ++i) {
+        const double distance = Side(m_faces[faces[i]], p);
+        if (distance > 0.0) {
+            AddToOutside(faces[i], p, distance);
+            return;
+        }
+    }
+}
+bool QuickHull::InitSimplex()
+{
+    // two extreme points along the axis of largest extent
+    int32_t minIndex[3] = { 0, 0, 0 };
+    int32_t maxIndex[3] = { 0, 0, 0 };
+    double minPt[3];
+    double maxPt[3];
+    double pt[3];
+    GetCoordinates(0, minPt);
+    GetCoordinates(0, maxPt);
+    for (int32_t p = 1; p < m_nPoints; ++p) {
+        GetCoordinates(p, pt);
+        for (int32_t k = 0; k < 3; ++k) {
+            if (pt[k] < minPt[k]) {
+                minPt[k] = pt[k];
+                minIndex[k] = p;
+            }
+            if (pt[k] > maxPt[k]) {
+                maxPt[k] = pt[k];
+                maxIndex[k] = p;
+            }
+        }
+    }
+    int32_t axis = 0;
+    double maxExtent = -1.0;
+    for (int32_t k = 0; k < 3; ++k) {
+        const double extent = maxPt[k] - minPt[k];
+        if (extent > maxExtent) {
+            maxExtent = extent;
+            axis = k;
+        }
+    }
+    if (!(maxExtent > 0.0)) {
+        return false;
+    }
+    // keeps the products of the exact lattice predicate within 64 bits
+    if (m_latticePoints && maxExtent >= 1048576.0) {
+        return false;
+    }
+    const int32_t i0 = minIndex[axis];
+    const int32_t i1 = maxIndex[axis];
+    double p0[3];
+    double p1[3];
+    GetCoordinates(i0, p0);
+    GetCoordinates(i1, p1);
+    // the point farthest from their line
+    const double u[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+    int32_t i2 = -1;
+    double maxDistance = 0.0;
+    for (int32_t p = 0; p < m_nPoints; ++p) {
+        GetCoordinates(p, pt);
+        const double w[3] = { pt[0] - p0[0], pt[1] - p0[1], pt[2] - p0[2] };
+        const double c[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+        const double distance = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+        if (distance > maxDistance) {
+            maxDistance = distance;
+            i2 = p;
+        }
+    }
+    if (i2 < 0) {
+        return false;
+    }
+    // the point farthest from their plane, which must certainly be off the plane
+    double p2[3];
+    GetCoordinates(i2, p2);
+    const double v[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+    const double n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+    int32_t i3 = -1;
+    maxDistance = 0.0;
+    for (int32_t p = 0; p < m_nPoints; ++p) {
+        GetCoordinates(p, pt);
+        const double distance = fabs(n[0] * (pt[0] - p0[0]) + n[1] * (pt[1] - p0[1]) + n[2] * (pt[2] - p0[2]));
+        if (distance > maxDistance) {
+            maxDistance = distance;
+            i3 = p;
+        }
+    }
+    if (i3 < 0) {
+        return false;
+    }
+    Face base;
+    base.m_vertices[0] = i0;
+    base.m_vertices[1] = i1;
+    base.m_vertices[2] = i2;
+    const double orientation = Side(base, i3);
+    if (orientation == 0.0) {
+        return false;
+    }
+    // (a, b, c) is counter-clockwise seen from outside when d is below it
+    const int32_t a = i0;
+    const int32_t b = (orientation < 0.0) ? i1 : i2;
+    const int32_t c = (orientation < 0.0) ? i2 : i1;
+    const int32_t d = i3;
+    const int32_t f0 = AddFace(a, b, c);
+    const int32_t f1 = AddFace(b, a, d);
+    const int32_t f2 = AddFace(c, b, d);
+    const int32_t f3 = AddFace(a, c, d);
+    m_faces[f0].m_adjacent[0] = f1;
+    m_faces[f0].m_adjacent[1] = f2;
+    m_faces[f0].m_adjacent[2] = f3;
+    m_faces[f1].m_adjacent[0] = f0;
+    m_faces[f1].m_adjacent[1] = f3;
+    m_faces[f1].m_adjacent[2] = f2;
+    m_faces[f2].m_adjacent[0] = f0;
+    m_faces[f2].m_adjacent[1] = f1;
+    m_faces[f2].m_adjacent[2] = f3;
+    m_faces[f3].m_adjacent[0] = f0;
+    m_faces[f3].m_adjacent[1] = f2;
+    m_faces[f3].m_adjacent[2] = f1;
+
+    const int32_t faces[4] = { f0, f1, f2, f3 };
+    for (int32_t p = 0; p < m_nPoints; ++p) {
+        if (p != a && p != b && p != c && p != d) {
+            AssignPoint(p, faces, 4);
+        }
+    }
+    for (int32_t i = 0; i < 4; ++i) {
+        if (m_faces[faces[i]].m_outside >= 0) {
+            m_pendingFaces.push_back(faces[i]);
+        }
+    }
+    return true;
+}
+bool QuickHull::AddVertex(const int32_t f)
+{
+    const int32_t eye = m_faces[f].m_farthest;
+    // faces certainly seen from the eye point, connected to f
+    ++m_stamp;
+    m_visibleFaces.resize(0);
+    m_horizon.resize(0);
+    m_faces[f].m_stamp = m_stamp;
+    m_faces[f].m_visible = true;
+    m_visibleFaces.push_back(f);
+    for (size_t i = 0; i < m_visibleFaces.size(); ++i) {
+        const int32_t vf = m_visibleFaces[i];
+        for (int32_t k = 0; k < 3; ++k) {
+            const int32_t g = m_faces[vf].m_adjacent[k];
+            Face& face = m_faces[g];
+            if (face.m_stamp != m_stamp) {
+                face.m_stamp = m_stamp;
+                face.m_visible = Side(face, eye) > 0.0;
+                if (face.m_visible) {
+                    m_visibleFaces.push_back(g);
+                }
+            }
+            if (!face.m_visible) {
+                HorizonEdge edge;
+                edge.m_v0 = m_faces[vf].m_vertices[k];
+                edge.m_v1 = m_faces[vf].m_vertices[(k + 1) % 3];
+                edge.m_face = g;
+                for (edge.m_edge = 0; face.m_vertices[edge.m_edge] != edge.m_v1; ++edge.m_edge)
+                    ;
+                m_horizon.push_back(edge);
+            }
+        }
+    }
+    // the visible faces must form a disk, bounded by a single cycle of horizon edges
+    const int32_t nHorizon = static_cast<int32_t>(m_horizon.size());
+    for (int32_t h = 0; h < nHorizon; ++h) {
+        const int32_t v0 = m_horizon[h].m_v0;
+        if (m_vertexStamps[v0] == m_stamp) {
+            return false;
+        }
+        m_vertexStamps[v0] = m_stamp;
+        m_vertexHorizon[v0] = h;
+    }
+    int32_t h = 0;
+    int32_t nCycle = 0;
+    do {
+        const int32_t v1 = m_horizon[h].m_v1;
+        if (m_vertexStamps[v1] != m_stamp) {
+            return false;
+        }
+        h = m_vertexHorizon[v1];
+        ++nCycle;
+    } while (h != 0 && nCycle <= nHorizon);
+    if (nCycle != nHorizon) {
+        return false;
+    }
+    // remove the visible faces and collect the points of their outside sets
+    m_orphans.resize(0);
+    for (size_t i = 0; i < m_visibleFaces.size(); ++i) {
+        Face& face = m_faces[m_visibleFaces[i]];
+        for (int32_t p = face.m_outside; p >= 0; p = m_nextOutside[p]) {
+            if (p != eye) {
+                m_orphans.push_back(p);
+            }
+        }
+        face.m_alive = false;
+        m_freeFaces.push_back(m_visibleFaces[i]);
+    }
+    // build the cone of faces joining the horizon to the eye point, in the order of the cycle
+    m_newFaces.resize(0);
+    h = 0;
+    do {
+        const HorizonEdge& edge = m_horizon[h];
+        const int32_t nf = AddFace(edge.m_v0, edge.m_v1, eye);
+        m_faces[nf].m_adjacent[0] = edge.m_face;
+        m_faces[edge.m_face].m_adjacent[edge.m_edge] = nf;
+        m_newFaces.push_back(nf);
+        h = m_vertexHorizon[edge.m_v1];
+    } while (h != 0);
+    const size_t nNewFaces = m_newFaces.size();
+    for (size_t i = 0; i < nNewFaces; ++i) {
+        const int32_t next = m_newFaces[(i + 1) % nNewFaces];
+        m_faces[m_newFaces[i]].m_adjacent[1] = next;
+        m_faces[next].m_adjacent[2] = m_newFaces[i];
+    }
+    // the orphans can only be outside of the new faces
+    for (size_t i = 0; i < m_orphans.size(); ++i) {
+        AssignPoint(m_orphans[i], &m_newFaces[0], nNewFaces);
+    }
+    for (size_t i = 0; i < nNewFaces; ++i) {
+        if (m_faces[m_newFaces[i]].m_outside >= 0) {
+            m_pendingFaces.push_back(m_newFaces[i]);
+        }
+    }
+    return true;
+}
+bool QuickHull::CheckConvexity() const
+{
+    // the vertex of each neighbor opposite to the shared edge must not be certainly above the face
+    const int32_t nFaces = static_cast<int32_t>(m_faces.size());
+    for (int32_t f = 0; f < nFaces; ++f) {
+        const Face& face = m_faces[f];
+        if (!face.m_alive) {
+            continue;
+        }
+        for (int32_t k = 0; k < 3; ++k) {
+            const Face& neighbor = m_faces[face.m_adjacent[k]];
+            const int32_t v1 = face.m_vertices[(k + 1) % 3];
+            int32_t j = 0;
+            while (neighbor.m_vertices[j] != v1) {
+                ++j;
+            }
+            if (neighbor.m_vertices[(j + 1) % 3] != face.m_vertices[k] || Side(face, neighbor.m_vertices[(j + 2) % 3]) > 0.0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+bool QuickHull::Compact()
+{
+    // gather the faces into groups of coplanar faces, connected through their edges, each of them tested against the
+    // plane of the first face of its group so that nearly flat regions do not drift
+    const int32_t nFaces = static_cast<int32_t>(m_faces.size());
+    m_faceGroups.assign(nFaces, -1);
+    m_groupFaces.resize(0);
+    m_groupOffsets.resize(0);
+    for (int32_t f = 0; f < nFaces; ++f) {
+        if (!m_faces[f].m_alive || m_faceGroups[f] >= 0) {
+            continue;
+        }
+        const int32_t group = static_cast<int32_t>(m_groupOffsets.size());
+        const size_t first = m_groupFaces.size();
+        m_groupOffsets.push_back(static_cast<int32_t>(first));
+        m_faceGroups[f] = group;
+        m_groupFaces.push_back(f);
+        for (size_t i = first; i < m_groupFaces.size(); ++i) {
+            const Face& face = m_faces[m_groupFaces[i]];
+            for (int32_t k = 0; k < 3; ++k) {
+                const int32_t g = face.m_adjacent[k];
+                if (m_faceGroups[g] >= 0) {
+                    continue;
+                }
+                const Face& neighbor = m_faces[g];
+                int32_t j = 0;
+                while (neighbor.m_vertices[j] != face.m_vertices[(k + 1) % 3]) {
+                    ++j;
+                }
+                if (Side(m_faces[f], neighbor.m_vertices[(j + 2) % 3]) == 0.0) {
+                    m_faceGroups[g] = group;
+                    m_groupFaces.push_back(g);
+                }
+            }
+        }
+    }
+    const int32_t nGroups = static_cast<int32_t>(m_groupOffsets.size());
+    m_groupOffsets.push_back(static_cast<int32_t>(m_groupFaces.size()));
+    // a point is a vertex of the hull when at least three groups meet at it, otherwise it lies inside a face or an edge
+    ++m_stamp;
+    for (int32_t f = 0; f < nFaces; ++f) {
+        if (!m_faces[f].m_alive) {
+            continue;
+        }
+        const int32_t group = m_faceGroups[f];
+        for (int32_t k = 0; k < 3; ++k) {
+            const int32_t v = m_faces[f].m_vertices[k];
+            int32_t* const groups = &m_vertexGroups[2 * v];
+            if (groups[0] < 0) {
+                groups[0] = group;
+            }
+            else if (groups[0] != group && groups[1] < 0) {
+                groups[1] = group;
+            }
+            else if (groups[0] != group && groups[1] != group && m_vertexStamps[v] != m_stamp) {
+                m_vertexStamps[v] = m_stamp;
+                m_vertexHorizon[v] = -1;
+            }
+        }
+    }
+    // each group is bounded by a single cycle of edges, whose vertices form the polygon of the face, numbering the
+    // vertices in the order they are first used
+    m_hullVertices.resize(0);
+    m_hullFaceOffsets.assign(1, 0);
+    m_hullFaceVertices.resize(0);
+    for (int32_t group = 0; group < nGroups; ++group) {
+        int32_t nBoundary = 0;
+        int32_t start = -1;
+        for (int32_t i = m_groupOffsets[group]; i < m_groupOffsets[group + 1]; ++i) {
+            const Face& face = m_faces[m_groupFaces[i]];
+            for (int32_t k = 0; k < 3; ++k) {
+                if (m_faceGroups[face.m_adjacent[k]] == group) {
+                    continue;
+                }
+                const int32_t v0 = face.m_vertices[k];
+                if (m_boundaryNext[v0] >= 0) {
+                    return false;
+                }
+                m_boundaryNext[v0] = face.m_vertices[(k + 1) % 3];
+                ++nBoundary;
+                if (start < 0 && m_vertexStamps[v0] == m_stamp) {
+                    start = v0;
+                }
+            }
+        }
+        if (start < 0) {
+            return false;
+        }
+        int32_t v = start;
+        int32_t nCycle = 0;
+        do {
+            if (m_vertexStamps[v] == m_stamp) {
+                if (m_vertexHorizon[v] < 0) {
+                    m_vertexHorizon[v] = static_cast<int32_t>(m_hullVertices.size());
+                    m_hullVertices.push_back(v);
+                }
+                m_hullFaceVertices.push_back(m_vertexHorizon[v]);
+            }
+            const int32_t next = m_boundaryNext[v];
+            m_boundaryNext[v] = -1;
+            v = next;
+            ++nCycle;
+        } while (v != start && v >= 0 && nCycle <= nBoundary);
+        if (v != start || nCycle != nBoundary || static_cast<int32_t>(m_hullFaceVertices.size()) - m_hullFaceOffsets.back() < 3) {
+            return false;
+        }
+        m_hullFaceOffsets.push_back(static_cast<int32_t>(m_hullFaceVertices.size()));
+    }
+    // pair the half-edges, through the list of the half-edges leaving each vertex
+    const int32_t nVertices = static_cast<int32_t>(m_hullVertices.size());
+    const int32_t nEdges = static_cast<int32_t>(m_hullFaceVertices.size());
+    m_edgeOffsets.assign(nVertices + 1, 0);
+    for (int32_t h = 0; h < nEdges; ++h) {
+        ++m_edgeOffsets[m_hullFaceVertices[h] + 1];
+    }
+    for (int32_t v = 0; v < nVertices; ++v) {
+        m_edgeOffsets[v + 1] += m_edgeOffsets[v];
+    }
+    m_vertexEdges.resize(nEdges);
+    m_edgeTargets.resize(nEdges);
+    for (int32_t f = 0; f < nGroups; ++f) {
+        const int32_t first = m_hullFaceOffsets[f];
+        const int32_t size = m_hullFaceOffsets[f + 1] - first;
+        for (int32_t i = 0; i < size; ++i) {
+            m_vertexEdges[m_edgeOffsets[m_hullFaceVertices[first + i]]++] = first + i;
+            m_edgeTargets[first + i] = m_hullFaceVertices[first + (i + 1) % size];
+        }
+    }
+    for (int32_t v = nVertices; v > 0; --v) {
+        m_edgeOffsets[v] = m_edgeOffsets[v - 1];
+    }
+    m_edgeOffsets[0] = 0;
+    m_hullTwinEdges.assign(nEdges, -1);
+    for (int32_t h = 0; h < nEdges; ++h) {
+        const int32_t v0 = m_hullFaceVertices[h];
+        const int32_t v1 = m_edgeTargets[h];
+        for (int32_t e = m_edgeOffsets[v1]; e < m_edgeOffsets[v1 + 1]; ++e) {
+            if (m_edgeTargets[m_vertexEdges[e]] == v0) {
+                m_hullTwinEdges[h] = m_vertexEdges[e];
+                break;
+            }
+        }
+        if (m_hullTwinEdges[h] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+bool QuickHull::Compute(const double* const points, const int32_t stride, const int32_t nPoints)
+{
+    m_points = points;
+    m_latticePoints = 0;
+    m_stride = stride;
+    return Compute(nPoints);
+}
+bool QuickHull::Compute(const int32_t* const points, const int32_t nPoints)
+{
+    m_points = 0;
+    m_latticePoints = points;
+    m_stride = 3 * sizeof(int32_t);
+    return Compute(nPoints);
+}
+bool QuickHull::Compute(const int32_t nPoints)
+{
+    m_nPoints = nPoints;
+    m_stamp = 0;
+    m_faces.resize(0);
+    m_freeFaces.resize(0);
+    m_pendingFaces.resize(0);
+    m_hullVertices.resize(0);
+    m_hullFaceOffsets.assign(1, 0);
+    m_hullFaceVertices.resize(0);
+    m_hullTwinEdges.resize(0);
+    if (nPoints < 4) {
+        return false;
+    }
+    m_nextOutside.resize(nPoints);
+    m_vertexStamps.assign(nPoints, 0);
+    m_vertexHorizon.resize(nPoints);
+    m_vertexGroups.assign(2 * static_cast<size_t>(nPoints), -1);
+    m_boundaryNext.assign(nPoints, -1);
+    if (!InitSimplex()) {
+        return false;
+    }
+    while (!m_pendingFaces.empty()) {
+        const int32_t f = m_pendingFaces.back();
+        m_pendingFaces.pop_back();
+        if (m_faces[f].m_alive && m_faces[f].m_outside >= 0 && !AddVertex(f)) {
+            return false;
+        }
+    }
+    if (!CheckConvexity()) {
+        return false;
+    }
+    if (!Compact()) {
+        m_hullVertices.resize(0);
+        m_hullFaceOffsets.assign(1, 0);
+        return false;
+    }
+    return true;
+}
+}
@@ -1,6 +1,9 @@
 #include "vhacdRaycastMesh.h"
 #include <math.h>
 #include <assert.h>
+#include <float.h>
+#include <vector>
+#include <algorithm>
 
 namespace RAYCAST_MESH
 {
@@ -64,6 +67,99 @@ static double getPointDistance(const double *p1, const double *p2)
 	return sqrt(dx*dx + dy*dy + dz*dz);
 }
 
+// Node of the bounding volume hierarchy, flattened in depth-first order: the left child of an interior node is the
+// node that follows it, and 'mOffset' is the index of its right child. A leaf references 'mCount' triangles starting
+// at 'mOffset'.
+struct BVHNode
+{
+	double		mMin[3];
+	double		mMax[3];
+	uint32_t	mOffset;
+	uint32_t	mCount;		// zero for interior nodes
+};
+
+// Triangle bounds used while building the hierarchy
+struct BVHBuildTriangle
+{
+	double		mMin[3];
+	double		mMax[3];
+	double		mCentroid[3];
+};
+
+static const uint32_t BVH_MAX_LEAF_SIZE = 4;	// nodes with more triangles are split...
+static const uint32_t BVH_MAX_SAH_LEAF_SIZE = 16;	// ...unless the SAH finds it cheaper to keep up to this many in a leaf
+static const uint32_t BVH_SAH_BINS = 16;
+static const uint32_t BVH_MAX_DEPTH = 64;	// deeper nodes are made leaves, which bounds the traversal stack
+static const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+static inline double getHalfArea(const double *bmin, const double *bmax)
+{
+	double dx = bmax[0] - bmin[0];
+	double dy = bmax[1] - bmin[1];
+	double dz = bmax[2] - bmin[2];
+	return dx*dy + dy*dz + dz*dx;
+}
+
+static inline void growBounds(double *bmin, double *bmax, const double *pmin, const double *pmax)
+{
+	for (uint32_t k = 0; k < 3; k++)
+	{
+		if (pmin[k] < bmin[k]) bmin[k] = pmin[k];
+		if (pmax[k] > bmax[k]) bmax[k] = pmax[k];
+	}
+}
+
+static inline void resetBounds(double *bmin, double *bmax)
+{
+	bmin[0] = bmin[1] = bmin[2] = DBL_MAX;
+	bmax[0] = bmax[1] = bmax[2] = -DBL_MAX;
+}
+
+// Distance from a point to a box, a lower bound of the distance to any hit inside the box
+static inline double getPointBoxDistance(const double *p, const BVHNode &node)
+{
+	double d2 = 0;
+	for (uint32_t k = 0; k < 3; k++)
+	{
+		double d = 0;
+		if (p[k] < node.mMin[k]) d = node.mMin[k] - p[k];
+		else if (p[k] > node.mMax[k]) d = p[k] - node.mMax[k];
+		d2 += d*d;
+	}
+	return sqrt(d2);
+}
+
+// Slab test of the ray (t >= 0) against a box
+static inline bool rayIntersectsBox(const double *p, const double *d, const double *invD, const BVHNode &node)
+{
+	double tmin = 0;
+	double tmax = DBL_MAX;
+	for (uint32_t k = 0; k < 3; k++)
+	{
+		if (d[k] == 0)
+		{
+			if (p[k] < node.mMin[k] || p[k] > node.mMax[k])
+				return false;
+		}
+		else
+		{
+			double t1 = (node.mMin[k] - p[k]) * invD[k];
+			double t2 = (node.mMax[k] - p[k]) * invD[k];
+			if (t1 > t2)
+			{
+				double t = t1;
+				t1 = t2;
+				t2 = t;
+			}
+			if (t1 > tmin) tmin = t1;
+			if (t2 < tmax) tmax = t2;
+			if (tmin > tmax)
+				return false;
+		}
+	}
+	return true;
+}
+
 class MyRaycastMesh : public VHACD::RaycastMesh
 {
 public:
@@ -74,31 +170,57 @@ public:
                   uint32_t tcount,
                   const uint32_t *indices)
 	{
-        mVcount = vcount;
-        mVertices = new double[mVcount * 3];
-        for (uint32_t i = 0; i < mVcount; i++)
-        {
-            mVertices[i * 3 + 0] = vertices[0];
-            mVertices[i * 3 + 1] = vertices[1];
-            mVertices[i * 3 + 2] = vertices[2];
-            vertices += 3;
-        }
-        mTcount = tcount;
-        mIndices = new uint32_t[mTcount * 3];
-        for (uint32_t i = 0; i < mTcount; i++)
-        {
-            mIndices[i * 3 + 0] = indices[0];
-            mIndices[i * 3 + 1] = indices[1];
-            mIndices[i * 3 + 2] = indices[2];
-            indices += 3;
-        }
-	}
-
-
-	~MyRaycastMesh(void)
-	{
-        delete[]mVertices;
-        delete[]mIndices;
+		std::vector<double> points(vcount * 3);
+		for (uint32_t i = 0; i < vcount * 3; i++)
+		{
+			points[i] = vertices[i];
+		}
+		// Bounds and centroids of the triangles, and bounds of the whole mesh to size the box inflation
+		std::vector<BVHBuildTriangle> triangles(tcount);
+		double meshMin[3], meshMax[3];
+		resetBounds(meshMin, meshMax);
+		for (uint32_t i = 0; i < tcount; i++)
+		{
+			BVHBuildTriangle &tri = triangles[i];
+			resetBounds(tri.mMin, tri.mMax);
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				const double *p = &points[indices[i * 3 + j] * 3];
+				growBounds(tri.mMin, tri.mMax, p, p);
+			}
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				tri.mCentroid[k] = (tri.mMin[k] + tri.mMax[k]) * 0.5;
+			}
+			growBounds(meshMin, meshMax, tri.mMin, tri.mMax);
+		}
+		mTriangleIds.resize(tcount);
+		for (uint32_t i = 0; i < tcount; i++)
+		{
+			mTriangleIds[i] = i;
+		}
+		if (tcount)
+		{
+			// The boxes are slightly inflated, so that the rounding errors of the ray/triangle test can not make
+			// the traversal miss a hit, nor underestimate its distance
+			double diagonal = sqrt((meshMax[0] - meshMin[0])*(meshMax[0] - meshMin[0]) +
+				(meshMax[1] - meshMin[1])*(meshMax[1] - meshMin[1]) +
+				(meshMax[2] - meshMin[2])*(meshMax[2] - meshMin[2]));
+			mInflation = diagonal * 1e-6 + 1e-12;
+			buildNode(triangles, 0, tcount, 0);
+		}
+		// The vertices of the triangles are stored in leaf order, so that a leaf is read contiguously
+		mTriangleVertices.resize(tcount * 9);
+		for (uint32_t i = 0; i < tcount; i++)
+		{
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				const double *p = &points[indices[mTriangleIds[i] * 3 + j] * 3];
+				mTriangleVertices[i * 9 + j * 3 + 0] = p[0];
+				mTriangleVertices[i * 9 + j * 3 + 1] = p[1];
+				mTriangleVertices[i * 9 + j * 3 + 2] = p[2];
+			}
+		}
 	}
 
 	virtual void release(void)
@@ -112,8 +234,6 @@ public:
 		double *hitLocation,			// The point where the ray hit nearest to the 'closestToPoint' location
 		double *hitDistance) final		// The distance the ray traveled to the hit location
 	{
-		bool ret = false;
-
 		double dir[3];
 
 		dir[0] = to[0] - from[0];
@@ -126,55 +246,220 @@ public:
 		dir[0]*=recipDistance;
 		dir[1]*=recipDistance;
 		dir[2]*=recipDistance;
-		const uint32_t *indices = mIndices;
-		const double *vertices = mVertices;
-		double nearestDistance = distance;
+		if (mNodes.empty())
+			return false;
 
-		for (uint32_t tri=0; tri<mTcount; tri++)
+		double invDir[3];
+		for (uint32_t k = 0; k < 3; k++)
 		{
-			uint32_t i1 = indices[tri*3+0];
-			uint32_t i2 = indices[tri*3+1];
-			uint32_t i3 = indices[tri*3+2];
-
-			const double *p1 = &vertices[i1*3];
-			const double *p2 = &vertices[i2*3];
-			const double *p3 = &vertices[i3*3];
-
-			double t;
-			if ( rayIntersectsTriangle(from,dir,p1,p2,p3,t))
+			invDir[k] = (dir[k] != 0) ? 1.0 / dir[k] : 0;
+		}
+		// Among the hits closer than 'distance' to 'closestToPoint', the closest one is kept, ties going to the
+		// first triangle of the source mesh, as when every triangle is tested in order
+		double nearestDistance = distance;
+		uint32_t nearestTriangle = NO_TRIANGLE;
+		double nearestHit[3];
+		uint32_t stack[BVH_MAX_DEPTH + 1];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			const BVHNode &node = mNodes[stack[--stackSize]];
+			if (getPointBoxDistance(closestToPoint, node) > nearestDistance || !rayIntersectsBox(from, dir, invDir, node))
+				continue;
+			if (node.mCount)
 			{
-				double hitPos[3];
+				for (uint32_t i = node.mOffset; i < node.mOffset + node.mCount; i++)
+				{
+					const double *p1 = &mTriangleVertices[i * 9];
+					const double *p2 = p1 + 3;
+					const double *p3 = p1 + 6;
+					double t;
+					if ( rayIntersectsTriangle(from,dir,p1,p2,p3,t))
+					{
+						double hitPos[3];
+
+						hitPos[0] = from[0] + dir[0] * t;
+						hitPos[1] = from[1] + dir[1] * t;
+						hitPos[2] = from[2] + dir[2] * t;
+
+						double pointDistance = getPointDistance(hitPos, closestToPoint);
+						uint32_t triangle = mTriangleIds[i];
+						if (pointDistance < nearestDistance ||
+							(pointDistance == nearestDistance && nearestTriangle != NO_TRIANGLE && triangle < nearestTriangle))
+						{
+							nearestDistance = pointDistance;
+							nearestTriangle = triangle;
+							nearestHit[0] = hitPos[0];
+							nearestHit[1] = hitPos[1];
+							nearestHit[2] = hitPos[2];
+						}
+					}
+				}
+			}
+			else
+			{
+				// The child closest to 'closestToPoint' is visited first
+				uint32_t left = (uint32_t)(&node - &mNodes[0]) + 1;
+				uint32_t right = node.mOffset;
+				if (getPointBoxDistance(closestToPoint, mNodes[left]) <= getPointBoxDistance(closestToPoint, mNodes[right]))
+				{
+					stack[stackSize++] = right;
+					stack[stackSize++] = left;
+				}
+				else
+				{
+					stack[stackSize++] = left;
+					stack[stackSize++] = right;
+				}
+			}
+		}
+		if (nearestTriangle == NO_TRIANGLE)
+			return false;
+		if ( hitLocation )
+		{
+			hitLocation[0] = nearestHit[0];
+			hitLocation[1] = nearestHit[1];
+			hitLocation[2] = nearestHit[2];
+		}
+		if ( hitDistance )
+		{
+			*hitDistance = nearestDistance;
+		}
+		return true;
+	}
 
-				hitPos[0] = from[0] + dir[0] * t;
-				hitPos[1] = from[1] + dir[1] * t;
-				hitPos[2] = from[2] + dir[2] * t;
+	virtual uint32_t raycastBatch(uint32_t rayCount,
+		const double *from,
+		const double *to,
+		const double *closestToPoints,
+		double *hitLocations,
+		double *hitDistances,
+		bool *hits) final
+	{
+		uint32_t hitCount = 0;
+		for (uint32_t i = 0; i < rayCount; i++)
+		{
+			hits[i] = raycast(from, &to[i * 3], &closestToPoints[i * 3], &hitLocations[i * 3], &hitDistances[i]);
+			if (hits[i])
+			{
+				hitCount++;
+			}
+		}
+		return hitCount;
+	}
 
-				double pointDistance = getPointDistance(hitPos, closestToPoint);
+private:
+	// Builds the node of the triangles [begin, end) of 'mTriangleIds' and its children, splitting them with the
+	// surface area heuristic (binned along the centroid bounds), and returns the index of the node
+	uint32_t buildNode(const std::vector<BVHBuildTriangle> &triangles, uint32_t begin, uint32_t end, uint32_t depth)
+	{
+		uint32_t nodeIndex = (uint32_t)mNodes.size();
+		mNodes.push_back(BVHNode());
+		BVHNode node;
+		double centroidMin[3], centroidMax[3];
+		resetBounds(node.mMin, node.mMax);
+		resetBounds(centroidMin, centroidMax);
+		for (uint32_t i = begin; i < end; i++)
+		{
+			const BVHBuildTriangle &tri = triangles[mTriangleIds[i]];
+			growBounds(node.mMin, node.mMax, tri.mMin, tri.mMax);
+			growBounds(centroidMin, centroidMax, tri.mCentroid, tri.mCentroid);
+		}
+		for (uint32_t k = 0; k < 3; k++)
+		{
+			node.mMin[k] -= mInflation;
+			node.mMax[k] += mInflation;
+		}
+		node.mOffset = begin;
+		node.mCount = end - begin;
 
-				if (pointDistance < nearestDistance )
+		uint32_t count = end - begin;
+		uint32_t bestAxis = 3;
+		uint32_t bestSplit = 0;
+		if (count > BVH_MAX_LEAF_SIZE && depth < BVH_MAX_DEPTH)
+		{
+			// Cost of a split, in triangle tests, relative to a traversal step
+			double bestCost = DBL_MAX;
+			double area = getHalfArea(node.mMin, node.mMax);
+			for (uint32_t k = 0; k < 3; k++)
+			{
+				double extent = centroidMax[k] - centroidMin[k];
+				if (extent <= 0)
+					continue;
+				uint32_t binCounts[BVH_SAH_BINS] = { 0 };
+				double binMin[BVH_SAH_BINS][3], binMax[BVH_SAH_BINS][3];
+				for (uint32_t b = 0; b < BVH_SAH_BINS; b++)
 				{
-					nearestDistance = pointDistance;
-					if ( hitLocation )
-					{
-						hitLocation[0] = hitPos[0];
-						hitLocation[1] = hitPos[1];
-						hitLocation[2] = hitPos[2];
-					}
-					if ( hitDistance )
+					resetBounds(binMin[b], binMax[b]);
+				}
+				double scale = BVH_SAH_BINS / extent;
+				for (uint32_t i = begin; i < end; i++)
+				{
+					const BVHBuildTriangle &tri = triangles[mTriangleIds[i]];
+					uint32_t b = getBin(tri.mCentroid[k], centroidMin[k], scale);
+					binCounts[b]++;
+					growBounds(binMin[b], binMax[b], tri.mMin, tri.mMax);
+				}
+				// Sweep from the right to get the area of every right side, then from the left to evaluate the splits
+				double rightAreas[BVH_SAH_BINS];
+				double sweepMin[3], sweepMax[3];
+				resetBounds(sweepMin, sweepMax);
+				for (uint32_t b = BVH_SAH_BINS - 1; b > 0; b--)
+				{
+					growBounds(sweepMin, sweepMax, binMin[b], binMax[b]);
+					rightAreas[b] = getHalfArea(sweepMin, sweepMax);
+				}
+				resetBounds(sweepMin, sweepMax);
+				uint32_t leftCount = 0;
+				for (uint32_t b = 1; b < BVH_SAH_BINS; b++)
+				{
+					growBounds(sweepMin, sweepMax, binMin[b - 1], binMax[b - 1]);
+					leftCount += binCounts[b - 1];
+					uint32_t rightCount = count - leftCount;
+					if (leftCount == 0 || rightCount == 0)
+						continue;
+					double cost = 1.0 + (getHalfArea(sweepMin, sweepMax) * leftCount + rightAreas[b] * rightCount) / area;
+					if (cost < bestCost)
 					{
-						*hitDistance = pointDistance;
+						bestCost = cost;
+						bestAxis = k;
+						bestSplit = b;
 					}
-					ret = true;
 				}
 			}
+			if (bestAxis < 3 && bestCost >= count && count <= BVH_MAX_SAH_LEAF_SIZE)
+			{
+				bestAxis = 3; // cheaper as a leaf
+			}
 		}
-		return ret;
+		if (bestAxis < 3)
+		{
+			double scale = BVH_SAH_BINS / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+			uint32_t *first = &mTriangleIds[begin];
+			uint32_t *middle = std::partition(first, first + count, [&](uint32_t id)
+			{
+				return getBin(triangles[id].mCentroid[bestAxis], centroidMin[bestAxis], scale) < bestSplit;
+			});
+			uint32_t split = begin + (uint32_t)(middle - first);
+			node.mCount = 0;
+			buildNode(triangles, begin, split, depth + 1);
+			node.mOffset = buildNode(triangles, split, end, depth + 1);
+		}
+		mNodes[nodeIndex] = node;
+		return nodeIndex;
+	}
+
+	static inline uint32_t getBin(double centroid, double centroidMin, double scale)
+	{
+		uint32_t b = (uint32_t)((centroid - centroidMin) * scale);
+		return (b < BVH_SAH_BINS) ? b : BVH_SAH_BINS - 1;
 	}
 
-	uint32_t		mVcount;
-	double	        *mVertices;
-	uint32_t		mTcount;
-	uint32_t	    *mIndices;
+	std::vector<BVHNode>	mNodes;
+	std::vector<uint32_t>	mTriangleIds;		// index in the source mesh of the triangles, in leaf order
+	std::vector<double>		mTriangleVertices;	// vertices of the triangles, in leaf order
+	double					mInflation{ 0 };
 };
 
 };
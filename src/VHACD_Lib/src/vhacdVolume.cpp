@@ -18,6 +18,7 @@
 #endif
 
 #include "btConvexHullComputer.h"
+#include "vhacdQuickHull.h"
 #include "vhacdVolume.h"
 #include <algorithm>
 #include <float.h>
@@ -404,16 +405,28 @@ void VoxelSet::ComputeBB()
         m_barycenter[h] = (short)(bary[h] + 0.5);
     }
 }
-void VoxelSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling) const
+void VoxelSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling, btConvexHullComputer* const hullComputer) const
 {
     const size_t CLUSTER_SIZE = 65536;
     const size_t nVoxels = m_voxels.Size();
     if (nVoxels == 0)
         return;
 
-    SArray<Vec3<double> > cpoints;
+    btConvexHullComputer localHullComputer;
+    btConvexHullComputer& ch = (hullComputer) ? *hullComputer : localHullComputer;
+    if (ch.useQuickHull && ComputeLatticeConvexHull(meshCH, sampling, ch)) {
+        return;
+    }
 
-    Vec3<double>* points = new Vec3<double>[CLUSTER_SIZE];
+    // the point buffers of the hull computer only grow, so that successive hulls do not allocate
+    const int32_t clusterSize = (int32_t)(3 * std::min(CLUSTER_SIZE, 8 * nVoxels));
+    if (ch.clusterPoints.size() < clusterSize) {
+        ch.clusterPoints.resize(clusterSize);
+    }
+    btAlignedObjectArray<double>& cpoints = ch.clusterHullPoints;
+    cpoints.resize(0);
+
+    Vec3<double>* points = (Vec3<double>*)&ch.clusterPoints[0];
     size_t p = 0;
     size_t s = 0;
     short i, j, k;
@@ -447,17 +460,16 @@ void VoxelSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling) const
             }
             ++p;
         }
-        btConvexHullComputer ch;
         ch.compute((double*)points, 3 * sizeof(double), (int32_t)q, -1.0, -1.0);
         for (int32_t v = 0; v < ch.vertices.size(); v++) {
-            cpoints.PushBack(Vec3<double>(ch.vertices[v].getX(), ch.vertices[v].getY(), ch.vertices[v].getZ()));
+            cpoints.push_back(ch.vertices[v].getX());
+            cpoints.push_back(ch.vertices[v].getY());
+            cpoints.push_back(ch.vertices[v].getZ());
         }
     }
-    delete[] points;
 
-    points = cpoints.Data();
-    btConvexHullComputer ch;
-    ch.compute((double*)points, 3 * sizeof(double), (int32_t)cpoints.Size(), -1.0, -1.0);
+    const double* const hullPoints = (cpoints.size()) ? &cpoints[0] : 0;
+    ch.compute(hullPoints, 3 * sizeof(double), cpoints.size() / 3, -1.0, -1.0);
     meshCH.ResizePoints(0);
     meshCH.ResizeTriangles(0);
     for (int32_t v = 0; v < ch.vertices.size(); v++) {
@@ -478,6 +490,57 @@ void VoxelSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling) const
         }
     }
 }
+// offsets of the corners of a voxel on the lattice of doubled voxel coordinates, in the order of GetPoints()
+static const int32_t g_cornerOffsets[8][3] = {
+    { -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+    { -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 }
+};
+bool VoxelSet::ComputeLatticeConvexHull(Mesh& meshCH, const size_t sampling, btConvexHullComputer& ch) const
+{
+    // the voxel corners (i +/- 0.5) * m_scale + m_minBB are exactly represented on the lattice of doubled voxel
+    // coordinates, whose hull is computed with exact integer predicates, the scale and offset being only applied
+    // to its vertices. The corners are stored in the hull computer, which belongs to the calling thread.
+    const size_t nVoxels = m_voxels.Size();
+    VHACD::QuickHull& hull = ch.getQuickHull();
+    std::vector<int32_t>& corners = hull.GetLatticeBuffer();
+    corners.resize(0);
+    size_t s = 0;
+    for (size_t p = 0; p < nVoxels; ++p) {
+        if (m_voxels[p].m_data == PRIMITIVE_ON_SURFACE && ++s == sampling) {
+            s = 0;
+            const int32_t i = 2 * m_voxels[p].m_coord[0];
+            const int32_t j = 2 * m_voxels[p].m_coord[1];
+            const int32_t k = 2 * m_voxels[p].m_coord[2];
+            for (int32_t c = 0; c < 8; ++c) {
+                corners.push_back(i + g_cornerOffsets[c][0]);
+                corners.push_back(j + g_cornerOffsets[c][1]);
+                corners.push_back(k + g_cornerOffsets[c][2]);
+            }
+        }
+    }
+    const int32_t nCorners = static_cast<int32_t>(corners.size() / 3);
+    if (nCorners == 0 || !hull.Compute(&corners[0], nCorners)) {
+        return false;
+    }
+    meshCH.ResizePoints(0);
+    meshCH.ResizeTriangles(0);
+    const int32_t nv = hull.GetNVertices();
+    for (int32_t v = 0; v < nv; ++v) {
+        const int32_t* const corner = &corners[3 * static_cast<size_t>(hull.GetVertex(v))];
+        meshCH.AddPoint(Vec3<double>((corner[0] * 0.5) * m_scale + m_minBB[0],
+            (corner[1] * 0.5) * m_scale + m_minBB[1],
+            (corner[2] * 0.5) * m_scale + m_minBB[2]));
+    }
+    const int32_t nf = hull.GetNFaces();
+    for (int32_t f = 0; f < nf; ++f) {
+        const int32_t* const face = hull.GetFace(f);
+        const int32_t size = hull.GetFaceSize(f);
+        for (int32_t i = 2; i < size; ++i) {
+            meshCH.AddTriangle(Vec3<int32_t>(face[0], face[i - 1], face[i]));
+        }
+    }
+    return true;
+}
 void VoxelSet::GetPoints(const Voxel& voxel,
     Vec3<double>* const pts) const
 {
@@ -593,27 +656,6 @@ void VoxelSet::ComputeExteriorPoints(const Plane& plane,
         }
     }
 }
-void VoxelSet::ComputeClippedVolumes(const Plane& plane,
-    double& positiveVolume,
-    double& negativeVolume) const
-{
-    negativeVolume = 0.0;
-    positiveVolume = 0.0;
-    const size_t nVoxels = m_voxels.Size();
-    if (nVoxels == 0)
-        return;
-    double d;
-    Vec3<double> pt;
-    size_t nPositiveVoxels = 0;
-    for (size_t v = 0; v < nVoxels; ++v) {
-        pt = GetPoint(m_voxels[v]);
-        d = plane.m_a * pt[0] + plane.m_b * pt[1] + plane.m_c * pt[2] + plane.m_d;
-        nPositiveVoxels += (d >= 0.0);
-    }
-    size_t nNegativeVoxels = nVoxels - nPositiveVoxels;
-    positiveVolume = m_unitVolume * nPositiveVoxels;
-    negativeVolume = m_unitVolume * nNegativeVoxels;
-}
 void VoxelSet::SelectOnSurface(PrimitiveSet* const onSurfP) const
 {
     VoxelSet* const onSurf = (VoxelSet*)onSurfP;
@@ -1093,16 +1135,25 @@ void TetrahedronSet::ComputeBB()
     }
     m_barycenter /= (double)(4 * nTetrahedra);
 }
-void TetrahedronSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling) const
+void TetrahedronSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling, btConvexHullComputer* const hullComputer) const
 {
     const size_t CLUSTER_SIZE = 65536;
     const size_t nTetrahedra = m_tetrahedra.Size();
     if (nTetrahedra == 0)
         return;
 
-    SArray<Vec3<double> > cpoints;
+    btConvexHullComputer localHullComputer;
+    btConvexHullComputer& ch = (hullComputer) ? *hullComputer : localHullComputer;
+
+    // the point buffers of the hull computer only grow, so that successive hulls do not allocate
+    const int32_t clusterSize = (int32_t)(3 * std::min(CLUSTER_SIZE, 4 * nTetrahedra));
+    if (ch.clusterPoints.size() < clusterSize) {
+        ch.clusterPoints.resize(clusterSize);
+    }
+    btAlignedObjectArray<double>& cpoints = ch.clusterHullPoints;
+    cpoints.resize(0);
 
-    Vec3<double>* points = new Vec3<double>[CLUSTER_SIZE];
+    Vec3<double>* points = (Vec3<double>*)&ch.clusterPoints[0];
     size_t p = 0;
     while (p < nTetrahedra) {
         size_t q = 0;
@@ -1123,17 +1174,16 @@ void TetrahedronSet::ComputeConvexHull(Mesh& meshCH, const size_t sampling) cons
             }
             ++p;
         }
-        btConvexHullComputer ch;
         ch.compute((double*)points, 3 * sizeof(double), (int32_t)q, -1.0, -1.0);
         for (int32_t v = 0; v < ch.vertices.size(); v++) {
-            cpoints.PushBack(Vec3<double>(ch.vertices[v].getX(), ch.vertices[v].getY(), ch.vertices[v].getZ()));
+            cpoints.push_back(ch.vertices[v].getX());
+            cpoints.push_back(ch.vertices[v].getY());
+            cpoints.push_back(ch.vertices[v].getZ());
         }
     }
-    delete[] points;
 
-    points = cpoints.Data();
-    btConvexHullComputer ch;
-    ch.compute((double*)points, 3 * sizeof(double), (int32_t)cpoints.Size(), -1.0, -1.0);
+    const double* const hullPoints = (cpoints.size()) ? &cpoints[0] : 0;
+    ch.compute(hullPoints, 3 * sizeof(double), cpoints.size() / 3, -1.0, -1.0);
     meshCH.ResizePoints(0);
     meshCH.ResizeTriangles(0);
     for (int32_t v = 0; v < ch.vertices.size(); v++) {
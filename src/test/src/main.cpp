@@ -101,10 +101,13 @@ struct Parameters {
     string m_fileNameOut;
     string m_fileNameLog;
     bool m_run;
+    unsigned int m_remergeMaxHulls;
+    vector<uint32_t> m_lodMaxHulls;
     IVHACD::Parameters m_paramsVHACD;
     Parameters(void)
     {
         m_run = true;
+        m_remergeMaxHulls = 0;
         m_oclPlatformID = 0;
         m_oclDeviceID = 0;
         m_fileNameIn = "";
@@ -182,6 +185,19 @@ int main(int argc, char* argv[])
         msg << "\t max. vertices per convex-hull               " << params.m_paramsVHACD.m_maxNumVerticesPerCH << endl;
         msg << "\t min. volume to add vertices to convex-hulls " << params.m_paramsVHACD.m_minVolumePerCH << endl;
         msg << "\t convex-hull approximation                   " << params.m_paramsVHACD.m_convexhullApproximation << endl;
+        msg << "\t adaptive plane search                       " << params.m_paramsVHACD.m_adaptivePlaneSearch << endl;
+        msg << "\t max. number of exact clipping planes        " << params.m_paramsVHACD.m_maxExactClippingPlanes << endl;
+        msg << "\t sparse hull merge                           " << params.m_paramsVHACD.m_sparseHullMerge << endl;
+        msg << "\t merge bounding box tolerance                " << params.m_paramsVHACD.m_mergeAABBTolerance << endl;
+        msg << "\t lazy hull merge                             " << params.m_paramsVHACD.m_lazyHullMerge << endl;
+        msg << "\t floating-point hulls                        " << params.m_paramsVHACD.m_floatingPointHulls << endl;
+        msg << "\t hull point filter                           " << params.m_paramsVHACD.m_filterHullPoints << endl;
+        msg << "\t re-merge maxhulls                           " << params.m_remergeMaxHulls << endl;
+        msg << "\t LOD maxhulls                                ";
+        for (size_t l = 0; l < params.m_lodMaxHulls.size(); ++l) {
+            msg << (l ? "," : "") << params.m_lodMaxHulls[l];
+        }
+        msg << endl;
         msg << "\t OpenCL acceleration                         " << params.m_paramsVHACD.m_oclAcceleration << endl;
         msg << "\t OpenCL platform ID                          " << params.m_oclPlatformID << endl;
         msg << "\t OpenCL device ID                            " << params.m_oclDeviceID << endl;
@@ -226,6 +242,18 @@ int main(int argc, char* argv[])
         bool res = interfaceVHACD->Compute(&points[0], (unsigned int)points.size() / 3,
             (const uint32_t *)&triangles[0], (unsigned int)triangles.size() / 3, params.m_paramsVHACD);
 
+        if (res) {
+            msg.str("");
+            msg << "+ Clipping planes: " << interfaceVHACD->GetNEvaluatedClippingPlanes() << " evaluated, "
+                << interfaceVHACD->GetNScreenedClippingPlanes() << " screened" << endl;
+            myLogger.Log(msg.str().c_str());
+        }
+        if (res && params.m_remergeMaxHulls > 0) {
+            msg.str("");
+            msg << "+ Re-merge to " << params.m_remergeMaxHulls << " convex-hulls " << endl;
+            myLogger.Log(msg.str().c_str());
+            res = interfaceVHACD->Remerge(params.m_remergeMaxHulls);
+        }
         if (res) {
             std::string ext;
             if (params.m_fileNameOut.length() > 4) {
@@ -279,6 +307,43 @@ int main(int argc, char* argv[])
             myLogger.Log("Decomposition cancelled by user!\n");
         }
 
+        if (res && !params.m_lodMaxHulls.empty()) {
+            msg.str("");
+            msg << "+ Compute " << params.m_lodMaxHulls.size() << " LODs" << endl;
+            myLogger.Log(msg.str().c_str());
+            if (interfaceVHACD->ComputeLODs(&params.m_lodMaxHulls[0], (uint32_t)params.m_lodMaxHulls.size())) {
+                // each LOD is saved as a Wavefront .obj file next to the output
+                std::string baseName = params.m_fileNameOut;
+                const size_t dot = baseName.find_last_of('.');
+                if (dot != std::string::npos) {
+                    baseName = baseName.substr(0, dot);
+                }
+                for (uint32_t l = 0; l < interfaceVHACD->GetNLODs(); ++l) {
+                    std::ostringstream fileName;
+                    fileName << baseName << "_lod" << l << ".obj";
+                    unsigned int nConvexHulls = interfaceVHACD->GetNLODConvexHulls(l);
+                    msg.str("");
+                    msg << "+ Generate LOD " << l << ": " << nConvexHulls << " convex-hulls (" << fileName.str() << ")" << endl;
+                    myLogger.Log(msg.str().c_str());
+                    ofstream foutCH(fileName.str().c_str());
+                    IVHACD::ConvexHull ch;
+                    if (foutCH.is_open()) {
+                        Material mat;
+                        int vertexOffset = 1;//obj wavefront starts counting at 1...
+                        for (unsigned int p = 0; p < nConvexHulls; ++p) {
+                            interfaceVHACD->GetLODConvexHull(l, p, ch);
+                            SaveOBJ(foutCH, ch.m_points, (const int *)ch.m_triangles, ch.m_nPoints, ch.m_nTriangles, mat, myLogger, p, vertexOffset);
+                            vertexOffset+=ch.m_nPoints;
+                        }
+                        foutCH.close();
+                    }
+                }
+            }
+            else {
+                myLogger.Log("LOD computation cancelled by user!\n");
+            }
+        }
+
 #ifdef CL_VERSION_1_1
         if (params.m_paramsVHACD.m_oclAcceleration) {
             bool res = interfaceVHACD->OCLRelease(&myLogger);
@@ -309,6 +374,8 @@ void Usage(const Parameters& params)
     msg << "       --log                       Log file name" << endl;
     msg << "       --resolution                Maximum number of voxels generated during the voxelization stage (default=100,000, range=10,000-16,000,000)" << endl;
     msg << "       --maxhulls                  Maximum number of convex hulls to produce." << endl;
+    msg << "       --remerge                   If non-zero, re-merge the decomposition to this maximum number of convex hulls after computing it (default=0)" << endl;
+    msg << "       --lods                      Comma separated maximum numbers of convex hulls of levels of detail computed in a single merge pass, each saved to <output>_lod<i>.obj (e.g. 128,32,8,1)" << endl;
     msg << "       --concavity                 Maximum allowed concavity (default=0.0025, range=0.0-1.0)" << endl;
     msg << "       --planeDownsampling         Controls the granularity of the search for the \"best\" clipping plane (default=4, range=1-16)" << endl;
     msg << "       --convexhullDownsampling    Controls the precision of the convex-hull generation process during the clipping plane selection stage (default=4, range=1-16)" << endl;
@@ -321,6 +388,13 @@ void Usage(const Parameters& params)
     msg << "       --maxNumVerticesPerCH       Controls the maximum number of triangles per convex-hull (default=64, range=4-1024)" << endl;
     msg << "       --minVolumePerCH            Controls the adaptive sampling of the generated convex-hulls (default=0.0001, range=0.0-0.01)" << endl;
     msg << "       --convexhullApproximation   Enable/disable approximation when computing convex-hulls (default=1, range={0,1})" << endl;
+    msg << "       --adaptivePlaneSearch       Enable/disable the coarse-to-fine search of the clipping planes (default=0, range={0,1})" << endl;
+    msg << "       --sparseMerge               Enable/disable merging only the convex-hulls with overlapping bounding boxes (default=0, range={0,1})" << endl;
+    msg << "       --mergeTolerance            Bounding box enlargement of the sparse merge, relative to the diagonal of all the convex-hulls (default=0.01, range=0.0-1.0)" << endl;
+    msg << "       --lazyMerge                 Enable/disable computing the exact merge costs only for the candidates whose cost lower bound is the lowest (default=0, range={0,1})" << endl;
+    msg << "       --floatingPointHulls        Enable/disable the floating-point Quickhull with exact fallback for the convex-hulls, and the exact lattice hull of the voxels (default=0, range={0,1})" << endl;
+    msg << "       --filterHullPoints          Enable/disable discarding the points inside the polytope of their extreme points before computing the convex-hulls; the hulls are unchanged but their vertex order, hence the output, can differ (default=0, range={0,1})" << endl;
+    msg << "       --maxExactPlanes            Maximum number of clipping planes per split evaluated with exact convex-hulls, the others are screened with a cheap proxy; with --adaptivePlaneSearch, the coarse planes are ranked with the proxy and the refinement stops after this many exact planes (default=0, 0 = all)" << endl;
     msg << "       --oclAcceleration           Enable/disable OpenCL acceleration (default=0, range={0,1})" << endl;
     msg << "       --oclPlatformID             OpenCL platform id (default=0, range=0-# OCL platforms)" << endl;
     msg << "       --oclDeviceID               OpenCL device id (default=0, range=0-# OCL devices)" << endl;
@@ -377,6 +451,20 @@ void ParseParameters(int argc, char* argv[], Parameters& params)
             if (++i < argc)
                 params.m_paramsVHACD.m_maxConvexHulls = atoi(argv[i]);
         }
+        else if (!strcmp(argv[i], "--remerge")) {
+            if (++i < argc)
+                params.m_remergeMaxHulls = atoi(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--lods")) {
+            if (++i < argc) {
+                params.m_lodMaxHulls.clear();
+                for (const char* c = argv[i]; *c; ) {
+                    params.m_lodMaxHulls.push_back((uint32_t)atoi(c));
+                    c = strchr(c, ',');
+                    c = c ? c + 1 : "";
+                }
+            }
+        }
         else if (!strcmp(argv[i], "--pca")) {
             if (++i < argc)
                 params.m_paramsVHACD.m_pca = atoi(argv[i]);
@@ -397,6 +485,34 @@ void ParseParameters(int argc, char* argv[], Parameters& params)
             if (++i < argc)
                 params.m_paramsVHACD.m_convexhullApproximation = atoi(argv[i]);
         }
+        else if (!strcmp(argv[i], "--adaptivePlaneSearch")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_adaptivePlaneSearch = (atoi(argv[i]) != 0);
+        }
+        else if (!strcmp(argv[i], "--maxExactPlanes")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_maxExactClippingPlanes = atoi(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--sparseMerge")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_sparseHullMerge = (atoi(argv[i]) != 0);
+        }
+        else if (!strcmp(argv[i], "--mergeTolerance")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_mergeAABBTolerance = atof(argv[i]);
+        }
+        else if (!strcmp(argv[i], "--lazyMerge")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_lazyHullMerge = (atoi(argv[i]) != 0);
+        }
+        else if (!strcmp(argv[i], "--floatingPointHulls")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_floatingPointHulls = (atoi(argv[i]) != 0);
+        }
+        else if (!strcmp(argv[i], "--filterHullPoints")) {
+            if (++i < argc)
+                params.m_paramsVHACD.m_filterHullPoints = (atoi(argv[i]) != 0);
+        }
         else if (!strcmp(argv[i], "--oclAcceleration")) {
             if (++i < argc)
                 params.m_paramsVHACD.m_oclAcceleration = atoi(argv[i]);
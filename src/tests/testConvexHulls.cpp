@@ -0,0 +1,264 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "btConvexHullComputer.h"
+#include "vhacdQuickHull.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Compares the hulls computed by QuickHull, directly and through btConvexHullComputer, with the ones of the exact
+// computer on point sets with many coplanar points: both must report the vertices of the hull only. The points span
+// 8 units along each axis, so that the grid the exact computer snaps them to (10216 steps) contains them exactly.
+// Then checks, on random clouds of non-integer points, that every point lies inside or on every face of the hulls
+// computed by QuickHull and by btConvexHullComputer, whether Quickhull certifies them or the exact computer takes over.
+
+// distances allowed above a face, relative to the largest coordinate of the cloud: QuickHull returns input points,
+// btConvexHullComputer single precision vertices, which the exact computer also snaps to its grid
+#define HULL_DISTANCE_TOLERANCE 1.0e-12
+#define HULL_FLOAT_DISTANCE_TOLERANCE 1.0e-6
+#define EXACT_HULL_GRID_STEPS 10216.0
+
+static uint32_t g_seed = 12345;
+static int32_t Random(const int32_t n)
+{
+    g_seed = 1664525u * g_seed + 1013904223u;
+    return static_cast<int32_t>((g_seed >> 8) % static_cast<uint32_t>(n));
+}
+static double RandomDouble(const double min, const double max)
+{
+    const double t = (Random(1 << 24) + Random(1 << 24) / 16777216.0) / 16777216.0;
+    return min + (max - min) * t;
+}
+static void AddPoint(std::vector<int32_t>& points, const int32_t x, const int32_t y, const int32_t z)
+{
+    points.push_back(x);
+    points.push_back(y);
+    points.push_back(z);
+}
+static int32_t ComputeHull(btConvexHullComputer& ch, const std::vector<double>& points, const bool useQuickHull)
+{
+    ch.useQuickHull = useQuickHull;
+    ch.usePointFilter = false;
+    ch.compute(&points[0], 3 * sizeof(double), static_cast<int32_t>(points.size() / 3), -1.0, -1.0);
+    return ch.vertices.size();
+}
+static bool Check(const char* const name, const std::vector<int32_t>& latticePoints)
+{
+    const int32_t nPoints = static_cast<int32_t>(latticePoints.size() / 3);
+    std::vector<double> points(latticePoints.begin(), latticePoints.end());
+    btConvexHullComputer ch;
+    const int32_t nVertices = ComputeHull(ch, points, false);
+    const int32_t nFaces = ch.faces.size();
+    const int32_t nQuickVertices = ComputeHull(ch, points, true);
+    const int32_t nQuickFaces = ch.faces.size();
+
+    VHACD::QuickHull quickHull;
+    const bool floatingPointOK = quickHull.Compute(&points[0], 3 * sizeof(double), nPoints);
+    const int32_t nFloatingPointVertices = quickHull.GetNVertices();
+    const bool latticeOK = quickHull.Compute(&latticePoints[0], nPoints);
+    const int32_t nLatticeVertices = quickHull.GetNVertices();
+    const int32_t nLatticeFaces = quickHull.GetNFaces();
+
+    const bool ok = floatingPointOK && latticeOK && nQuickVertices == nVertices && nQuickFaces == nFaces
+        && nFloatingPointVertices == nVertices && nLatticeVertices == nVertices && nLatticeFaces == nFaces;
+    printf("%-24s %6d points: exact %4d V %4d F, computer %4d V %4d F, floating-point %4d V, lattice %4d V %4d F %s\n",
+        name, nPoints, nVertices, nFaces, nQuickVertices, nQuickFaces, nFloatingPointVertices, nLatticeVertices,
+        nLatticeFaces, ok ? "OK" : "FAILED");
+    return ok;
+}
+// Largest distance of the points above the plane of a convex polygon (x, y, z triplets), whose normal is computed with
+// Newell's method
+static double ComputeMaxDistance(const std::vector<double>& points, const std::vector<double>& polygon)
+{
+    const size_t size = polygon.size() / 3;
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < size; ++i) {
+        const double* const a = &polygon[3 * i];
+        const double* const b = &polygon[3 * ((i + 1) % size)];
+        normal[0] += (a[1] - b[1]) * (a[2] + b[2]);
+        normal[1] += (a[2] - b[2]) * (a[0] + b[0]);
+        normal[2] += (a[0] - b[0]) * (a[1] + b[1]);
+        for (int32_t k = 0; k < 3; ++k) {
+            center[k] += a[k] / size;
+        }
+    }
+    const double norm = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    double maxDistance = 0.0;
+    for (size_t p = 0; p < points.size(); p += 3) {
+        const double distance = (normal[0] * (points[p] - center[0]) + normal[1] * (points[p + 1] - center[1])
+            + normal[2] * (points[p + 2] - center[2])) / norm;
+        if (distance > maxDistance) {
+            maxDistance = distance;
+        }
+    }
+    return maxDistance;
+}
+static bool CheckContainment(const char* const name, const std::vector<double>& points)
+{
+    const int32_t nPoints = static_cast<int32_t>(points.size() / 3);
+    double scale = 0.0;
+    double minPt[3] = { points[0], points[1], points[2] };
+    double maxPt[3] = { points[0], points[1], points[2] };
+    for (size_t p = 0; p < points.size(); ++p) {
+        scale = fabs(points[p]) > scale ? fabs(points[p]) : scale;
+        minPt[p % 3] = points[p] < minPt[p % 3] ? points[p] : minPt[p % 3];
+        maxPt[p % 3] = points[p] > maxPt[p % 3] ? points[p] : maxPt[p % 3];
+    }
+    // diagonal of a cell of the grid of the exact computer, which truncates the coordinates
+    double gridDistance = 0.0;
+    for (int32_t k = 0; k < 3; ++k) {
+        const double step = (maxPt[k] - minPt[k]) / EXACT_HULL_GRID_STEPS;
+        gridDistance += step * step;
+    }
+    gridDistance = sqrt(gridDistance);
+    std::vector<double> polygon;
+
+    VHACD::QuickHull quickHull;
+    const bool certified = quickHull.Compute(&points[0], 3 * sizeof(double), nPoints);
+    double quickHullDistance = 0.0;
+    if (certified) {
+        for (int32_t f = 0; f < quickHull.GetNFaces(); ++f) {
+            polygon.resize(0);
+            for (int32_t i = 0; i < quickHull.GetFaceSize(f); ++i) {
+                const double* const pt = &points[3 * quickHull.GetVertex(quickHull.GetFace(f)[i])];
+                polygon.insert(polygon.end(), pt, pt + 3);
+            }
+            const double distance = ComputeMaxDistance(points, polygon);
+            quickHullDistance = distance > quickHullDistance ? distance : quickHullDistance;
+        }
+    }
+
+    btConvexHullComputer ch;
+    const int32_t nVertices = ComputeHull(ch, points, true);
+    const int32_t nFaces = ch.faces.size();
+    double computerDistance = 0.0;
+    for (int32_t f = 0; f < nFaces; ++f) {
+        polygon.resize(0);
+        const btConvexHullComputer::Edge* const first = &ch.edges[ch.faces[f]];
+        const btConvexHullComputer::Edge* edge = first;
+        do {
+            const btVector3& pt = ch.vertices[edge->getTargetVertex()];
+            polygon.push_back(pt[0]);
+            polygon.push_back(pt[1]);
+            polygon.push_back(pt[2]);
+            edge = edge->getNextEdgeOfFace();
+        } while (edge != first);
+        const double distance = ComputeMaxDistance(points, polygon);
+        computerDistance = distance > computerDistance ? distance : computerDistance;
+    }
+
+    const bool ok = nFaces >= 4 && (!certified || quickHull.GetNVertices() == nVertices)
+        && quickHullDistance <= HULL_DISTANCE_TOLERANCE * scale
+        && computerDistance <= HULL_FLOAT_DISTANCE_TOLERANCE * scale + (certified ? 0.0 : gridDistance);
+    printf("%-24s %6d points: %s, computer %4d V %4d F, distance above the faces %.3g, computer %.3g %s\n", name,
+        nPoints, certified ? "certified" : "exact fallback", nVertices, nFaces, quickHullDistance / scale,
+        computerDistance / scale, ok ? "OK" : "FAILED");
+    return ok;
+}
+int main()
+{
+    bool ok = true;
+    std::vector<int32_t> points;
+
+    // every point of a grid: the hull is a cube whose faces contain 25 points each
+    for (int32_t x = 0; x <= 4; ++x) {
+        for (int32_t y = 0; y <= 4; ++y) {
+            for (int32_t z = 0; z <= 4; ++z) {
+                AddPoint(points, 2 * x, 2 * y, 2 * z);
+            }
+        }
+    }
+    ok &= Check("grid", points);
+
+    // random points of a small lattice cube, many of them on the same faces and edges
+    points.resize(0);
+    for (int32_t p = 0; p < 150; ++p) {
+        AddPoint(points, Random(9), Random(9), Random(9));
+    }
+    ok &= Check("random lattice cube", points);
+
+    // every point of a ball, whose hull has many faces holding more than three points
+    points.resize(0);
+    for (int32_t x = 0; x <= 8; ++x) {
+        for (int32_t y = 0; y <= 8; ++y) {
+            for (int32_t z = 0; z <= 8; ++z) {
+                if ((x - 4) * (x - 4) + (y - 4) * (y - 4) + (z - 4) * (z - 4) <= 16) {
+                    AddPoint(points, x, y, z);
+                }
+            }
+        }
+    }
+    ok &= Check("lattice ball", points);
+
+    // random points of a cube
+    std::vector<double> cloud;
+    for (int32_t p = 0; p < 1000; ++p) {
+        cloud.push_back(RandomDouble(-1.0, 1.0));
+        cloud.push_back(RandomDouble(-1.0, 1.0));
+        cloud.push_back(RandomDouble(-1.0, 1.0));
+    }
+    ok &= CheckContainment("random cube", cloud);
+
+    // the same points far from the origin
+    for (size_t p = 0; p < cloud.size(); p += 3) {
+        cloud[p] += 1.0e6;
+        cloud[p + 1] -= 3.0e6;
+        cloud[p + 2] += 7.0e5;
+    }
+    ok &= CheckContainment("random cube, offset", cloud);
+
+    // random points of a sphere, nearly all of them vertices of the hull
+    cloud.resize(0);
+    while (cloud.size() < 3 * 1000) {
+        const double x = RandomDouble(-1.0, 1.0);
+        const double y = RandomDouble(-1.0, 1.0);
+        const double z = RandomDouble(-1.0, 1.0);
+        const double norm = sqrt(x * x + y * y + z * z);
+        if (norm > 0.1 && norm < 1.0) {
+            cloud.push_back(x / norm);
+            cloud.push_back(y / norm);
+            cloud.push_back(z / norm);
+        }
+    }
+    ok &= CheckContainment("sphere", cloud);
+
+    // random points of a slab 10^12 times thinner than wide, whose side faces are slivers
+    cloud.resize(0);
+    for (int32_t p = 0; p < 1000; ++p) {
+        cloud.push_back(RandomDouble(-1.0, 1.0));
+        cloud.push_back(RandomDouble(-1.0, 1.0));
+        cloud.push_back(RandomDouble(-1.0e-12, 1.0e-12));
+    }
+    ok &= CheckContainment("near-flat slab", cloud);
+
+    // random points of the faces of a rotated cube, off them by the rounding of their coordinates only
+    cloud.resize(0);
+    const double c = cos(0.3);
+    const double s = sin(0.3);
+    for (int32_t p = 0; p < 1000; ++p) {
+        double pt[3] = { RandomDouble(-1.0, 1.0), RandomDouble(-1.0, 1.0), RandomDouble(-1.0, 1.0) };
+        pt[Random(3)] = Random(2) ? 1.0 : -1.0;
+        const double x = c * pt[0] - s * pt[1];
+        const double y = s * pt[0] + c * pt[1];
+        cloud.push_back(c * x + s * pt[2]);
+        cloud.push_back(y);
+        cloud.push_back(c * pt[2] - s * x);
+    }
+    ok &= CheckContainment("rotated cube surface", cloud);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "btConvexHullComputer.h"
+#include "vhacdHullPointFilter.h"
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Compares the hulls computed by btConvexHullComputer with and without the point pre-filter. The filter only discards
+// points strictly inside the hull, so both must have the same vertices; only their order may differ, which is why
+// the filter is off by default.
+
+static uint32_t g_seed = 4321;
+static double Random()
+{
+    g_seed = 1664525u * g_seed + 1013904223u;
+    return static_cast<double>(g_seed >> 8) / static_cast<double>(1 << 24);
+}
+static void ComputeHullVertices(btConvexHullComputer& ch, const std::vector<double>& points, const bool usePointFilter,
+    std::vector<std::vector<double> >& vertices)
+{
+    ch.usePointFilter = usePointFilter;
+    ch.compute(&points[0], 3 * sizeof(double), static_cast<int32_t>(points.size() / 3), -1.0, -1.0);
+    vertices.resize(0);
+    for (int32_t v = 0; v < ch.vertices.size(); ++v) {
+        std::vector<double> vertex(3);
+        vertex[0] = ch.vertices[v].getX();
+        vertex[1] = ch.vertices[v].getY();
+        vertex[2] = ch.vertices[v].getZ();
+        vertices.push_back(vertex);
+    }
+    std::sort(vertices.begin(), vertices.end());
+}
+// nPoints random points of the box [0, sx] x [0, sy] x [0, sz] translated by offset, optionally restricted to the
+// ellipsoid inscribed in it
+static bool Check(const char* const name, const int32_t nRuns, const int32_t nPoints, const double sx, const double sy,
+    const double sz, const double offset, const bool ball)
+{
+    btConvexHullComputer ch;
+    int32_t nFailed = 0;
+    uint64_t nRejectedPoints = 0;
+    for (int32_t run = 0; run < nRuns; ++run) {
+        std::vector<double> points;
+        while (points.size() < 3 * static_cast<size_t>(nPoints)) {
+            const double x = 2.0 * Random() - 1.0;
+            const double y = 2.0 * Random() - 1.0;
+            const double z = 2.0 * Random() - 1.0;
+            if (!ball || x * x + y * y + z * z <= 1.0) {
+                points.push_back(offset + 0.5 * sx * (x + 1.0));
+                points.push_back(offset + 0.5 * sy * (y + 1.0));
+                points.push_back(offset + 0.5 * sz * (z + 1.0));
+            }
+        }
+        std::vector<std::vector<double> > expected;
+        std::vector<std::vector<double> > filtered;
+        ComputeHullVertices(ch, points, false, expected);
+        const int32_t nExpectedFaces = ch.faces.size();
+        const uint64_t nRejectedPoints0 = ch.getPointFilter().GetNRejectedPoints();
+        ComputeHullVertices(ch, points, true, filtered);
+        nRejectedPoints += ch.getPointFilter().GetNRejectedPoints() - nRejectedPoints0;
+        if (filtered != expected || ch.faces.size() != nExpectedFaces) {
+            ++nFailed;
+        }
+    }
+    const bool ok = nFailed == 0;
+    printf("%-24s %4d runs of %5d points: %8d points discarded, %4d different hulls %s\n", name, nRuns, nPoints,
+        static_cast<int32_t>(nRejectedPoints), nFailed, ok ? "OK" : "FAILED");
+    return ok;
+}
+int main()
+{
+    bool ok = true;
+    ok &= Check("cube", 200, 1000, 1.0, 1.0, 1.0, 0.0, false);
+    ok &= Check("ball", 200, 1000, 1.0, 1.0, 1.0, 0.0, true);
+    ok &= Check("small ball", 200, 20, 1.0, 1.0, 1.0, 0.0, true);
+    ok &= Check("flat ellipsoid", 200, 1000, 10.0, 10.0, 0.01, 0.0, true);
+    ok &= Check("needle", 200, 1000, 100.0, 0.1, 0.1, 0.0, true);
+    ok &= Check("offset ball", 200, 1000, 1.0, 1.0, 1.0, 1000.0, true);
+    return ok ? 0 : 1;
+}
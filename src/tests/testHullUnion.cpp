@@ -0,0 +1,135 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "btConvexHullComputer.h"
+#include "vhacdMesh.h"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+
+// Compares the convex-hull of the union of two convex-hulls computed from the vertices left by
+// ConvexHullMesh::AddPointsOutside(), as the merge does, with the one recomputed from all the vertices of both hulls.
+// Culling only removes vertices strictly inside the other hull, so both point sets have the same bounding box and
+// the exact computer must return the same vertices.
+
+static uint32_t g_seed = 12345;
+static double Random()
+{
+    g_seed = 1664525u * g_seed + 1013904223u;
+    return static_cast<double>(g_seed >> 8) / static_cast<double>(1 << 24);
+}
+static VHACD::ConvexHullMesh* CreateHull(const std::vector<double>& points)
+{
+    btConvexHullComputer ch;
+    VHACD::Mesh mesh;
+    mesh.ComputeConvexHull(&points[0], points.size() / 3, &ch);
+    return new VHACD::ConvexHullMesh(std::move(mesh));
+}
+// points of a ball of the given radius around center, drawn uniformly in its bounding cube
+static VHACD::ConvexHullMesh* CreateBallHull(const double cx, const double cy, const double cz, const double radius)
+{
+    std::vector<double> points;
+    while (points.size() < 3 * 200) {
+        const double x = 2.0 * Random() - 1.0;
+        const double y = 2.0 * Random() - 1.0;
+        const double z = 2.0 * Random() - 1.0;
+        if (x * x + y * y + z * z <= 1.0) {
+            points.push_back(cx + radius * x);
+            points.push_back(cy + radius * y);
+            points.push_back(cz + radius * z);
+        }
+    }
+    return CreateHull(points);
+}
+static VHACD::ConvexHullMesh* CreateBoxHull(const double x0, const double y0, const double z0, const double x1,
+    const double y1, const double z1)
+{
+    std::vector<double> points;
+    for (int32_t k = 0; k < 8; ++k) {
+        points.push_back((k & 1) ? x1 : x0);
+        points.push_back((k & 2) ? y1 : y0);
+        points.push_back((k & 4) ? z1 : z0);
+    }
+    return CreateHull(points);
+}
+static void ComputeHullVertices(btConvexHullComputer& ch, const VHACD::SArray<VHACD::Vec3<double> >& points,
+    std::vector<std::vector<double> >& vertices)
+{
+    ch.compute((const double*)points.Data(), 3 * sizeof(double), static_cast<int32_t>(points.Size()), -1.0, -1.0);
+    vertices.resize(0);
+    for (int32_t v = 0; v < ch.vertices.size(); ++v) {
+        std::vector<double> vertex(3);
+        vertex[0] = ch.vertices[v].getX();
+        vertex[1] = ch.vertices[v].getY();
+        vertex[2] = ch.vertices[v].getZ();
+        vertices.push_back(vertex);
+    }
+    std::sort(vertices.begin(), vertices.end());
+}
+static bool Check(const char* const name, VHACD::ConvexHullMesh* const ch1, VHACD::ConvexHullMesh* const ch2,
+    const bool expectCulling)
+{
+    VHACD::SArray<VHACD::Vec3<double> > allPoints;
+    for (size_t v = 0; v < ch1->GetNPoints(); ++v) {
+        allPoints.PushBack(ch1->GetPoint(v));
+    }
+    for (size_t v = 0; v < ch2->GetNPoints(); ++v) {
+        allPoints.PushBack(ch2->GetPoint(v));
+    }
+    VHACD::SArray<VHACD::Vec3<double> > unionPoints;
+    ch1->AddPointsOutside(*ch2, unionPoints);
+    ch2->AddPointsOutside(*ch1, unionPoints);
+
+    btConvexHullComputer ch;
+    ch.usePointFilter = false;
+    std::vector<std::vector<double> > expected;
+    std::vector<std::vector<double> > culled;
+    ComputeHullVertices(ch, allPoints, expected);
+    const int32_t nExpectedFaces = ch.faces.size();
+    ComputeHullVertices(ch, unionPoints, culled);
+    const int32_t nFaces = ch.faces.size();
+
+    const bool ok = culled == expected && nFaces == nExpectedFaces
+        && (!expectCulling || unionPoints.Size() < allPoints.Size());
+    printf("%-24s %4d points, %4d after culling: recomputed %4d V %4d F, culled %4d V %4d F %s\n", name,
+        static_cast<int32_t>(allPoints.Size()), static_cast<int32_t>(unionPoints.Size()),
+        static_cast<int32_t>(expected.size()), nExpectedFaces, static_cast<int32_t>(culled.size()), nFaces,
+        ok ? "OK" : "FAILED");
+    delete ch1;
+    delete ch2;
+    return ok;
+}
+int main()
+{
+    bool ok = true;
+
+    // balls from disjoint to nested
+    const double offsets[] = { 0.0, 0.25, 0.5, 1.0, 1.5, 2.5 };
+    for (size_t k = 0; k < sizeof(offsets) / sizeof(offsets[0]); ++k) {
+        char name[64];
+        sprintf(name, "balls, offset %.2f", offsets[k]);
+        ok &= Check(name, CreateBallHull(0.0, 0.0, 0.0, 1.0), CreateBallHull(offsets[k], 0.0, 0.0, 1.0), offsets[k] < 2.0);
+    }
+    ok &= Check("nested balls", CreateBallHull(0.0, 0.0, 0.0, 1.0), CreateBallHull(0.1, 0.2, 0.0, 0.5), true);
+
+    // vertices on the faces of the other hull are not strictly inside it and have to be kept
+    ok &= Check("boxes sharing faces", CreateBoxHull(0.0, 0.0, 0.0, 2.0, 2.0, 2.0), CreateBoxHull(1.0, 0.0, 0.0, 3.0, 2.0, 2.0), false);
+    ok &= Check("box in a box corner", CreateBoxHull(0.0, 0.0, 0.0, 2.0, 2.0, 2.0), CreateBoxHull(0.0, 0.0, 0.0, 1.0, 1.0, 1.0), true);
+    ok &= Check("identical boxes", CreateBoxHull(0.0, 0.0, 0.0, 1.0, 2.0, 3.0), CreateBoxHull(0.0, 0.0, 0.0, 1.0, 2.0, 3.0), false);
+
+    return ok ? 0 : 1;
+}
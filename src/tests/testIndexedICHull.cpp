@@ -0,0 +1,141 @@
+/* Copyright (c) 2011 Khaled Mamou (kmamou at gmail dot com)
+ All rights reserved.
+ 
+ 
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ 
+ 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ 
+ 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ 
+ 3. The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "btConvexHullComputer.h"
+#include "vhacdMesh.h"
+#include "vhacdICHull.h"
+#include "vhacdIndexedICHull.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Compares IndexedICHull with ICHull, whose algorithm it implements: both have to return the same error and the
+// same vertices and triangles, in the same order. Coplanar and near-coplanar clouds exercise the points whose volumes
+// are within the tolerance of the hull, which the conflict lists have to recheck against the new faces.
+
+static uint32_t g_seed = 12345;
+static double Random()
+{
+    g_seed = 1664525u * g_seed + 1013904223u;
+    return static_cast<double>(g_seed >> 8) / static_cast<double>(1 << 24);
+}
+// points of the plane z = 0.25 x + 0.5 y, in [0, scale]^2, moved off it by at most thickness
+static void CreatePlane(const size_t nPoints, const double scale, const double thickness,
+    std::vector<VHACD::Vec3<double> >& points)
+{
+    points.resize(0);
+    for (size_t p = 0; p < nPoints; ++p) {
+        const double x = scale * Random();
+        const double y = scale * Random();
+        points.push_back(VHACD::Vec3<double>(x, y, 0.25 * x + 0.5 * y + thickness * (2.0 * Random() - 1.0)));
+    }
+}
+static void CreateBall(const size_t nPoints, std::vector<VHACD::Vec3<double> >& points)
+{
+    points.resize(0);
+    while (points.size() < nPoints) {
+        const double x = 2.0 * Random() - 1.0;
+        const double y = 2.0 * Random() - 1.0;
+        const double z = 2.0 * Random() - 1.0;
+        if (x * x + y * y + z * z <= 1.0) {
+            points.push_back(VHACD::Vec3<double>(x, y, z));
+        }
+    }
+}
+template <typename T>
+static bool Equal(const VHACD::Vec3<T>& a, const VHACD::Vec3<T>& b)
+{
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+static bool Check(const std::vector<VHACD::Vec3<double> >& points, const uint32_t nPointsCH, const double minVolume,
+    VHACD::IndexedICHull& indexedICHull)
+{
+    VHACD::ICHull icHull;
+    icHull.AddPoints(&points[0], points.size());
+    const VHACD::ICHullError expectedError = icHull.Process(nPointsCH, minVolume);
+    indexedICHull.Clear();
+    indexedICHull.AddPoints(&points[0], points.size());
+    const VHACD::ICHullError error = indexedICHull.Process(nPointsCH, minVolume);
+    if (error != expectedError) {
+        return false;
+    }
+    VHACD::TMMesh& mesh = icHull.GetMesh();
+    if (mesh.GetNVertices() != indexedICHull.GetNVertices() || mesh.GetNTriangles() != indexedICHull.GetNTriangles()) {
+        return false;
+    }
+    // an inconsistent ICHull mesh may refer to deleted vertices
+    if (error != VHACD::ICHullErrorOK) {
+        return true;
+    }
+    std::vector<VHACD::Vec3<double> > expectedPoints(mesh.GetNVertices() + 1);
+    std::vector<VHACD::Vec3<int32_t> > expectedTriangles(mesh.GetNTriangles() + 1);
+    std::vector<VHACD::Vec3<double> > hullPoints(expectedPoints.size());
+    std::vector<VHACD::Vec3<int32_t> > hullTriangles(expectedTriangles.size());
+    mesh.GetIFS(&expectedPoints[0], &expectedTriangles[0]);
+    indexedICHull.GetIFS(&hullPoints[0], &hullTriangles[0]);
+    for (size_t v = 0; v < mesh.GetNVertices(); ++v) {
+        if (!Equal(hullPoints[v], expectedPoints[v])) {
+            return false;
+        }
+    }
+    for (size_t t = 0; t < mesh.GetNTriangles(); ++t) {
+        if (!Equal(hullTriangles[t], expectedTriangles[t])) {
+            return false;
+        }
+    }
+    return true;
+}
+int main()
+{
+    bool ok = true;
+    VHACD::IndexedICHull indexedICHull;
+    std::vector<VHACD::Vec3<double> > points;
+    const size_t sizes[] = { 4, 5, 6, 8, 10, 16, 25, 50, 100, 200, 500, 1000, 2000 };
+    const size_t nSizes = sizeof(sizes) / sizeof(sizes[0]);
+    const int32_t nRuns = 5;
+    struct Cloud {
+        const char* m_name;
+        double m_scale; // 0 for a ball
+        double m_thickness;
+    };
+    const Cloud clouds[] = {
+        { "tilted plane", 1.0, 0.0 },
+        { "tilted plane x10", 10.0, 0.0 },
+        { "tilted plane x100", 100.0, 0.0 },
+        { "near-flat slab", 10.0, 1.0e-9 },
+        { "ball", 0.0, 0.0 },
+    };
+    for (size_t k = 0; k < sizeof(clouds) / sizeof(clouds[0]); ++k) {
+        const Cloud& cloud = clouds[k];
+        int32_t nFailed = 0;
+        for (size_t s = 0; s < nSizes; ++s) {
+            for (int32_t run = 0; run < nRuns; ++run) {
+                if (cloud.m_scale > 0.0) {
+                    CreatePlane(sizes[s], cloud.m_scale, cloud.m_thickness, points);
+                }
+                else {
+                    CreateBall(sizes[s], points);
+                }
+                // all the points, and at most 64 of them with a minimum volume, as the hull simplification does
+                nFailed += !Check(points, static_cast<uint32_t>(points.size()), 0.0, indexedICHull);
+                nFailed += !Check(points, 64, 1.0e-4, indexedICHull);
+            }
+        }
+        printf("%-18s %4d runs, %4d different from ICHull %s\n", cloud.m_name, static_cast<int32_t>(2 * nSizes * nRuns),
+            nFailed, (nFailed == 0) ? "OK" : "FAILED");
+        ok &= nFailed == 0;
+    }
+    return ok ? 0 : 1;
+}